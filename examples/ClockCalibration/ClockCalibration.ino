@@ -0,0 +1,74 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotSimulator.h>
+#include <BlockNotCalibrator.h>
+
+/*
+ * This sketch shows how BlockNotCalibrator trims a clock that runs at the wrong speed.
+ *
+ * Cheap ceramic resonators and the internal RC oscillators on a lot of boards can be off by
+ * thousands of parts per million, and that adds up - a board that is 0.25% slow loses more than
+ * three and a half minutes every day. If you have something accurate to compare against, like
+ * the one pulse per second output from a GPS module or the 1 Hz square wave from a DS3231 RTC,
+ * you call referencePulse() on every pulse (or referenceTime() with the time from NTP), and once
+ * it has enough samples the calibrator works out how far off the clock is and corrects the rate
+ * of the clock that every BlockNot timer uses.
+ *
+ * To make it easy to see without any extra hardware, this sketch runs on the virtual clock from
+ * BlockNotSimulator and builds a clock from it that runs 0.25% slow, then feeds the calibrator
+ * perfect one second pulses from the virtual clock. The ten second timer is measured before and
+ * after the calibration so you can see the difference.
+ *
+ * On real hardware you would leave out the simulator and the setClock() call and call
+ * calibrator.referencePulse() from your loop (or an interrupt flag) when the PPS pin goes high.
+ */
+
+#define SLOW_CLOCK_PER_10000 9975
+
+BlockNot tenSecondTimer(10, SECONDS);
+BlockNotCalibrator calibrator;
+
+unsigned long slowMillis() {
+    return static_cast<uint32_t>(BlockNotSimulator::now() * SLOW_CLOCK_PER_10000 / 10000 / 1000);
+}
+
+unsigned long slowMicros() {
+    return static_cast<uint32_t>(BlockNotSimulator::now() * SLOW_CLOCK_PER_10000 / 10000);
+}
+
+uint64_t measureTimer() {
+    tenSecondTimer.RESET;
+    const uint64_t start = BlockNotSimulator::now();
+    while (!tenSecondTimer.TRIGGERED) {
+        BlockNotSimulator::advance(SIM_MICROS_PER_MILLI);
+    }
+    return BlockNotSimulator::now() - start;
+}
+
+void printMeasurement(const char *label, const uint64_t micros) {
+    Serial.print(label);
+    Serial.print(static_cast<unsigned long>(micros / SIM_MICROS_PER_MILLI));
+    Serial.println(F(" ms of real time"));
+}
+
+void setup() {
+    Serial.begin(115200);
+    BlockNotSimulator::begin();
+    BlockNot::setClock(slowMillis, slowMicros);
+
+    printMeasurement("Ten second timer before calibration: ", measureTimer());
+
+    calibrator.referencePulse();
+    while (!calibrator.isCalibrated()) {
+        BlockNotSimulator::advance(SIM_MICROS_PER_SECOND);
+        calibrator.referencePulse();
+    }
+    Serial.print(F("Clock correction: "));
+    Serial.print(calibrator.getPpb());
+    Serial.println(F(" parts per billion"));
+
+    printMeasurement("Ten second timer after calibration:  ", measureTimer());
+    BlockNotSimulator::end();
+}
+
+void loop() {}
@@ -0,0 +1,69 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotSimulator.h>
+
+/*
+ * This sketch shows how timer slack cuts down the number of times your loop has to wake up.
+ *
+ * Lots of timers do not care if they trigger a few milliseconds late - telemetry, housekeeping,
+ * LED refreshes and so on. Give those timers some slack, and when BlockNot works out when the
+ * next wakeup should be (getMicrosUntilNextWakeup(), BlockNotTimerFd and BlockNotSimulator all
+ * use it), it lets each timer wait until the end of its slack window. Timers whose windows
+ * overlap then get handled in one wakeup instead of each one waking the loop on its own.
+ *
+ * The sketch runs one hour of the same timers in virtual time, once with coalescing turned off
+ * and once with it turned on, and prints the number of wakeups, the number of triggers and the
+ * latest any timer triggered compared to its duration. The control timer has no slack, so it is
+ * never late.
+ *
+ * The timers are checked with TRIGGERED_ON_DURATION, which keeps each one on its own schedule
+ * no matter how late it was noticed, so both runs end up with exactly the same number of
+ * triggers and the only thing that changes is how many wakeups it took. Plain TRIGGERED starts
+ * the next period from the moment it was noticed, so with slack every period would stretch by
+ * however late the timer was - the wakeups would go down because the timers trigger less often,
+ * not because they share wakeups.
+ */
+
+BlockNot controlTimer(100);
+BlockNot telemetryTimer(1000);
+BlockNot housekeepingTimer(333);
+BlockNot ledTimer(40);
+
+unsigned long worstLateness = 0;
+unsigned long triggers = 0;
+
+void checkLateness(BlockNot &timer) {
+    const unsigned long late = timer.LAST_TRIGGER_DURATION - timer.DURATION;
+    if (late > worstLateness) worstLateness = late;
+    triggers++;
+}
+
+void simulatedLoop() {
+    if (controlTimer.TRIGGERED_ON_DURATION()) checkLateness(controlTimer);
+    if (telemetryTimer.TRIGGERED_ON_DURATION()) checkLateness(telemetryTimer);
+    if (housekeepingTimer.TRIGGERED_ON_DURATION()) checkLateness(housekeepingTimer);
+    if (ledTimer.TRIGGERED_ON_DURATION()) checkLateness(ledTimer);
+}
+
+void runHour(const bool coalesce) {
+    BlockNot::setCoalescing(coalesce);
+    worstLateness = 0;
+    triggers = 0;
+    BlockNotSimulator::begin();
+    RESET_TIMERS;
+    const unsigned long wakeups = BlockNotSimulator::run(SIM_MICROS_PER_HOUR, simulatedLoop);
+    BlockNotSimulator::end();
+    Serial.println(String(coalesce ? "With coalescing:    " : "Without coalescing: ") + String(wakeups) + " wakeups, " + String(triggers) + " triggers, latest trigger " + String(worstLateness) + " ms");
+}
+
+void setup() {
+    Serial.begin(115200);
+    telemetryTimer.setSlack(50);
+    housekeepingTimer.setSlack(100);
+    ledTimer.setSlack(10);
+    runHour(false);
+    runHour(true);
+}
+
+void loop() {
+}
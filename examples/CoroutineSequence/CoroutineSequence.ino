@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotCoroutine.h>
+
+/*
+ * This sketch shows how to write a multi-step sequence as a C++20 coroutine instead of
+ * a hand-rolled state machine.
+ *
+ * The traffic light below would normally be a switch statement with a state variable,
+ * where each case checks TRIGGERED, changes the lights, sets the next duration and moves
+ * the state along. As a coroutine, it reads top to bottom exactly like the delay() version
+ * would - except that co_await gives control back to loop() while the timer runs, so
+ * nothing is ever blocked. The blink coroutine runs right alongside it.
+ *
+ * BlockNotExecutor::poll() in loop() checks every timer that a coroutine is waiting on and
+ * resumes the coroutine when it triggers. Coroutine frames come out of a small fixed pool
+ * inside the library, so no heap memory is used.
+ *
+ * This needs a compiler running in C++20 mode (ESP-IDF, recent ESP32 / RP2040 cores or
+ * Linux). On anything older, the sketch just tells you so.
+ */
+
+#ifdef BLOCKNOT_COROUTINES
+
+#define RED     2
+#define YELLOW  3
+#define GREEN   4
+
+BlockNot lightTimer(1, SECONDS);
+BlockNot blinkTimer(500);
+
+void lights(const bool red, const bool yellow, const bool green) {
+    digitalWrite(RED, red ? HIGH : LOW);
+    digitalWrite(YELLOW, yellow ? HIGH : LOW);
+    digitalWrite(GREEN, green ? HIGH : LOW);
+}
+
+BlockNotTask trafficLight() {
+    while (true) {
+        lights(true, false, false);
+        Serial.println("Red");
+        co_await lightTimer.after(5);
+
+        lights(false, false, true);
+        Serial.println("Green");
+        co_await lightTimer.after(4);
+
+        lights(false, true, false);
+        Serial.println("Yellow");
+        co_await lightTimer.after(1);
+    }
+}
+
+BlockNotTask blink() {
+    bool state = false;
+    while (true) {
+        co_await blinkTimer.next();
+        state = !state;
+        digitalWrite(LED_BUILTIN, state ? HIGH : LOW);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(RED, OUTPUT);
+    pinMode(YELLOW, OUTPUT);
+    pinMode(GREEN, OUTPUT);
+    pinMode(LED_BUILTIN, OUTPUT);
+    trafficLight();
+    blink();
+}
+
+void loop() {
+    BlockNotExecutor::poll();
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("This example needs a compiler in C++20 mode"));
+}
+
+void loop() {
+}
+
+#endif
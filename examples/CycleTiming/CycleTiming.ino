@@ -0,0 +1,66 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch uses a CYCLES timer to clock out bits at a rate that micros() can't keep up with,
+ * and times a short piece of code with getCycles().
+ *
+ * A CYCLES timer counts CPU clock cycles instead of microseconds. On boards that have a cycle
+ * counter (ESP32, ESP8266, Teensy 3/4, most ARM Cortex-M3 and up) reading it takes a single
+ * instruction, and every cycle counts, so you can time things down to a few nanoseconds. On
+ * boards without one, like the UNO, CYCLES still work, they just move in steps of micros().
+ *
+ * The bit clock below runs at 200 kHz, one bit every 5 microseconds, which is just over one
+ * micros() tick on an UNO and still plenty of cycles on anything faster.
+ *
+ * BlockNot takes the cycle frequency from F_CPU. If your core doesn't define it, it measures the
+ * counter against micros() the first time it is needed, and you can always set it yourself with
+ * BlockNot::setCycleFrequency() - for example, if you change the CPU speed at run time.
+ */
+
+#define DATA_PIN    4
+#define CLOCK_PIN   5
+#define BIT_RATE    200000UL
+
+BlockNot bitTimer(1, CYCLES, STOPPED);
+BlockNot reportTimer(2, SECONDS);
+
+const uint8_t message[] = {0xA5, 0x5A, 0xFF, 0x00};
+uint8_t bitIndex = 0;
+bool clockHigh = false;
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(DATA_PIN, OUTPUT);
+    pinMode(CLOCK_PIN, OUTPUT);
+    bitTimer.setDuration(BlockNot::getCycleFrequency() / BIT_RATE / 2);
+    bitTimer.START();
+    Serial.print(F("Cycle frequency: "));
+    Serial.print(BlockNot::getCycleFrequency());
+    Serial.print(F(" Hz, half a bit is "));
+    Serial.print(bitTimer.DURATION);
+    Serial.println(F(" cycles"));
+}
+
+void loop() {
+    if (bitTimer.TRIGGERED_ON_DURATION()) {
+        clockHigh = !clockHigh;
+        if (clockHigh) {
+            const uint8_t bit = (message[bitIndex / 8] >> (7 - bitIndex % 8)) & 1;
+            digitalWrite(DATA_PIN, bit ? HIGH : LOW);
+            bitIndex = (bitIndex + 1) % (sizeof(message) * 8);
+        }
+        digitalWrite(CLOCK_PIN, clockHigh ? HIGH : LOW);
+    }
+
+    if (reportTimer.TRIGGERED) {
+        const unsigned long start = BlockNot::getCycles();
+        digitalWrite(DATA_PIN, LOW);
+        const unsigned long cycles = BlockNot::getCycles() - start;
+        Serial.print(F("digitalWrite() took "));
+        Serial.print(cycles);
+        Serial.print(F(" cycles, "));
+        Serial.print(bitTimer.convert(cycles, MICROSECONDS));
+        Serial.println(F(" us"));
+    }
+}
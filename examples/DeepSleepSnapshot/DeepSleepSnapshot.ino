@@ -0,0 +1,71 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch shows how to carry the state of your timers across a deep sleep.
+ *
+ * When an ESP32 goes into deep sleep, everything in normal RAM is lost, so when it wakes
+ * up, every BlockNot timer starts over from zero. The timers all trigger at the same time
+ * and they lose the rhythm they had before the sleep.
+ *
+ * BlockNot can write every timer into a small binary snapshot (BLOCKNOT_SNAPSHOT_SIZE bytes)
+ * which is small enough to keep in RTC memory. When the board wakes up, you restore the
+ * snapshot and tell BlockNot how long it was asleep, and each timer picks up exactly where
+ * it would have been if the board had stayed awake the whole time.
+ *
+ * Timers are matched up by the order in which they were created, so keep your timer
+ * declarations in the same order between the snapshot and the restore.
+ *
+ * On boards other than the ESP32, the sketch simply simulates the sleep with a delay so
+ * you can still watch it work in the Serial monitor.
+ */
+
+#define SLEEP_SECONDS 5
+
+BlockNot heartbeatTimer(2, SECONDS);
+BlockNot reportTimer(7, SECONDS);
+BlockNot sleepTimer(12, SECONDS);
+
+#ifdef ESP32
+RTC_DATA_ATTR uint8_t timerSnapshot[BLOCKNOT_SNAPSHOT_SIZE(3)];
+RTC_DATA_ATTR size_t snapshotSize = 0;
+#else
+uint8_t timerSnapshot[BLOCKNOT_SNAPSHOT_SIZE(3)];
+size_t snapshotSize = 0;
+#endif
+
+void goToSleep() {
+    snapshotSize = BlockNot::snapshotAll(timerSnapshot, sizeof(timerSnapshot));
+    Serial.println("Saved " + String(snapshotSize) + " bytes of timer state, sleeping for " + String(SLEEP_SECONDS) + " seconds");
+    Serial.flush();
+#ifdef ESP32
+    esp_sleep_enable_timer_wakeup(SLEEP_SECONDS * 1000000ULL);
+    esp_deep_sleep_start();
+#else
+    delay(SLEEP_SECONDS * 1000UL);
+    BlockNot::restoreAll(timerSnapshot, snapshotSize, SLEEP_SECONDS * 1000UL);
+    Serial.println("Restored timer state after simulated sleep");
+#endif
+}
+
+void setup() {
+    Serial.begin(115200);
+    if (snapshotSize > 0) {
+        if (BlockNot::restoreAll(timerSnapshot, snapshotSize, SLEEP_SECONDS * 1000UL))
+            Serial.println("Woke up and restored timer state");
+        else
+            Serial.println("Snapshot did not match these timers, starting fresh");
+    }
+}
+
+void loop() {
+    if (heartbeatTimer.TRIGGERED) {
+        Serial.println("Heartbeat - report due in " + String(reportTimer.REMAINING) + " seconds");
+    }
+    if (reportTimer.TRIGGERED) {
+        Serial.println("Report");
+    }
+    if (sleepTimer.TRIGGERED) {
+        goToSleep();
+    }
+}
@@ -0,0 +1,80 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotTimerFd.h>
+
+/*
+ * This sketch is for running BlockNot inside a Linux process, using an Arduino API host
+ * core such as EpoxyDuino.
+ *
+ * On a microcontroller, spinning in loop() and checking TRIGGERED over and over is exactly
+ * what you want. On Linux, that same loop pins a whole CPU core at 100% while it waits.
+ *
+ * BlockNotTimerFd takes the earliest trigger out of all of your timers and arms a Linux
+ * timerfd with it. The timerfd is just another file descriptor, so it goes into epoll()
+ * right next to stdin (or sockets, pipes, serial ports ...) and the process sleeps until
+ * one of them has something to do. When it is idle, it uses next to no CPU at all.
+ *
+ * Type a line and hit enter to see the keyboard handled in the same loop as the timers.
+ */
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+BlockNot heartbeatTimer(1, SECONDS);
+BlockNot statusTimer(5, SECONDS);
+
+BlockNotTimerFd timerFd;
+int epollFd;
+
+void setup() {
+    Serial.begin(115200);
+    timerFd.begin();
+    epollFd = epoll_create1(0);
+    timerFd.addToEpoll(epollFd);
+
+    epoll_event input = {};
+    input.events = EPOLLIN;
+    input.data.fd = STDIN_FILENO;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &input);
+    Serial.println(F("Waiting on timers and stdin"));
+}
+
+void loop() {
+    timerFd.arm();
+    epoll_event events[4];
+    const int count = epoll_wait(epollFd, events, 4, -1);
+    for (int i = 0; i < count; i++) {
+        if (events[i].data.fd == timerFd.getFd()) {
+            timerFd.acknowledge();
+        }
+        else if (events[i].data.fd == STDIN_FILENO) {
+            char line[64];
+            const ssize_t length = read(STDIN_FILENO, line, sizeof(line) - 1);
+            if (length > 0) {
+                line[length] = 0;
+                Serial.print("You typed: ");
+                Serial.print(line);
+            }
+        }
+    }
+    if (heartbeatTimer.TRIGGERED) {
+        Serial.println("Heartbeat");
+    }
+    if (statusTimer.TRIGGERED) {
+        Serial.println("Status timer triggered, heartbeat due in " + String(heartbeatTimer.REMAINING) + " ms");
+    }
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("This example needs Linux"));
+}
+
+void loop() {
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch shows what each overrun policy does after the loop stalls.
+ *
+ * Four timers with the same 500ms duration are created, each with a different overrun
+ * policy. Every 10 seconds the loop is stalled for 3.2 seconds with delay() - long enough
+ * for each timer to miss six of its periods. Watch the Serial monitor to see how each
+ * timer deals with that:
+ *
+ *  SKIP       - triggers once and carries on from the most recent 500ms mark
+ *  BURST      - triggers once, then hands out up to two of the missed periods right away
+ *  SPREAD     - hands out all of the missed periods spaced evenly across the next 500ms
+ *  COUNT_ONLY - triggers once, resets to now and just counts what it missed
+ *
+ * Every timer keeps count of the periods it missed in getOverrunCount().
+ */
+
+BlockNot skipTimer(500);
+BlockNot burstTimer(500);
+BlockNot spreadTimer(500);
+BlockNot countTimer(500);
+BlockNot stallTimer(10, SECONDS);
+
+void check(BlockNot &timer, const String &name) {
+    if (timer.TRIGGERED) {
+        Serial.println(String(millis()) + "\t" + name + "\ttriggered, overruns so far: " + String(timer.getOverrunCount()));
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    skipTimer.setOverrunPolicy(OVERRUN_SKIP);
+    burstTimer.setOverrunPolicy(OVERRUN_BURST, 2);
+    spreadTimer.setOverrunPolicy(OVERRUN_SPREAD);
+    countTimer.setOverrunPolicy(OVERRUN_COUNT_ONLY);
+    RESET_TIMERS;
+}
+
+void loop() {
+    check(skipTimer, "SKIP      ");
+    check(burstTimer, "BURST     ");
+    check(spreadTimer, "SPREAD    ");
+    check(countTimer, "COUNT_ONLY");
+    if (stallTimer.TRIGGERED) {
+        Serial.println(F("\n*** Stalling the loop for 3.2 seconds ***\n"));
+        delay(3200);
+    }
+}
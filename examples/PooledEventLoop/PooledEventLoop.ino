@@ -0,0 +1,113 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotPool.h>
+#include <BlockNotTimerFd.h>
+
+/*
+ * This sketch is for running BlockNot inside a Linux process, using an Arduino API host
+ * core such as EpoxyDuino.
+ *
+ * Every line you type is treated as a request that needs an answer within two seconds, and
+ * the timeout for it comes from a BlockNotPool. Type the word "reply" to answer the oldest
+ * request that is still waiting. There are no other timers in the sketch, and the loop sleeps
+ * in epoll() with no timeout at all, so the only thing that can wake it up when nobody is
+ * typing is the timerfd.
+ *
+ * Timers in a pool are kept out of the global reset list, but the pool hands its deadlines to
+ * BlockNot as a wakeup source, so BlockNotTimerFd arms the timerfd for them just the same.
+ * Type a line, wait, and the timeout shows up on time along with how late the wakeup was.
+ */
+
+#if defined(__linux__)
+
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#define TIMEOUT_MS      2000
+
+BlockNotPool pool;
+BlockNotHandle waiting[BLOCKNOT_POOL_TIMERS];
+uint8_t waitingCount = 0;
+
+BlockNotTimerFd timerFd;
+int epollFd;
+
+void forget(const uint8_t index) {
+    pool.release(waiting[index]);
+    for (uint8_t i = index + 1; i < waitingCount; i++) waiting[i - 1] = waiting[i];
+    waitingCount--;
+}
+
+void handleLine(const char *line) {
+    if (strncmp(line, "reply", 5) == 0) {
+        if (waitingCount == 0) {
+            Serial.println("Nothing is waiting for a reply");
+            return;
+        }
+        Serial.println("Answered after " + String(pool.get(waiting[0])->getRawElapsed()) + " ms");
+        forget(0);
+        return;
+    }
+    const BlockNotHandle timeout = pool.acquire(TIMEOUT_MS);
+    if (timeout == NO_HANDLE) {
+        Serial.println("Too many requests waiting");
+        return;
+    }
+    waiting[waitingCount++] = timeout;
+    Serial.println("Waiting on " + String(waitingCount) + " request(s)");
+}
+
+void setup() {
+    Serial.begin(115200);
+    timerFd.begin();
+    epollFd = epoll_create1(0);
+    timerFd.addToEpoll(epollFd);
+
+    epoll_event input = {};
+    input.events = EPOLLIN;
+    input.data.fd = STDIN_FILENO;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &input);
+    Serial.println(F("Type a line to send a request, or \"reply\" to answer one"));
+}
+
+void loop() {
+    timerFd.arm();
+    epoll_event events[2];
+    const int count = epoll_wait(epollFd, events, 2, -1);
+    for (int i = 0; i < count; i++) {
+        if (events[i].data.fd == timerFd.getFd()) {
+            timerFd.acknowledge();
+        }
+        else if (events[i].data.fd == STDIN_FILENO) {
+            char line[64];
+            const ssize_t length = read(STDIN_FILENO, line, sizeof(line) - 1);
+            if (length > 0) {
+                line[length] = 0;
+                handleLine(line);
+            }
+        }
+    }
+    for (uint8_t i = 0; i < waitingCount;) {
+        const BlockNotStatus status = pool.get(waiting[i])->status();
+        if (status.due) {
+            Serial.println("Request timed out, woken up " + String(status.elapsed - status.duration) + " ms after it was due");
+            forget(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("This example needs Linux"));
+}
+
+void loop() {
+}
+
+#endif
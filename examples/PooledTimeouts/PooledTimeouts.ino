@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotPool.h>
+
+/*
+ * This sketch keeps a timeout for every request it has out, using timers from a BlockNotPool
+ * instead of creating and deleting them as requests come and go.
+ *
+ * Every 100 milliseconds it sends a (pretend) request and takes a 300 millisecond timeout from
+ * the pool. Replies come back at random - most in time, some too late and some never. When a
+ * reply comes in on time, the timeout goes back to the pool. When a timeout triggers first, the
+ * request is counted as lost and the timeout goes back to the pool.
+ *
+ * A reply that shows up after its request timed out still has the old handle, and by then the
+ * pool may have given that same timer to a newer request. The handle knows which use of the
+ * timer it belongs to, so pool.release() turns it down instead of cancelling someone else's
+ * timeout. Once a second the sketch prints how many requests were answered, how many timed out,
+ * how many late replies were caught, and how many timers are free.
+ */
+
+#define MAX_REQUESTS    BLOCKNOT_POOL_TIMERS
+#define TIMEOUT_MS      300
+
+struct Request {
+    BlockNotHandle timeout;
+    unsigned long replyAt;
+    bool replies;
+    bool timedOut;
+};
+
+BlockNotPool pool;
+BlockNot sendTimer(100);
+BlockNot reportTimer(1, SECONDS);
+
+Request requests[MAX_REQUESTS];
+uint8_t requestCount = 0;
+
+unsigned long answered = 0;
+unsigned long timedOut = 0;
+unsigned long lateReplies = 0;
+
+void sendRequest() {
+    if (requestCount >= MAX_REQUESTS) return;
+    const BlockNotHandle timeout = pool.acquire(TIMEOUT_MS);
+    if (timeout == NO_HANDLE) return;
+    // The reply takes anywhere from 50 to 450 milliseconds, one in five never comes back at all
+    requests[requestCount++] = {timeout, millis() + random(50, 450), random(5) != 0, false};
+}
+
+void checkRequests() {
+    for (uint8_t i = 0; i < requestCount; i++) {
+        Request &request = requests[i];
+        bool done = false;
+        if (!request.timedOut && pool.triggered(request.timeout)) {
+            pool.release(request.timeout);
+            request.timedOut = true;
+            timedOut++;
+            // If a reply is still on the way, keep waiting for it with the handle it was sent with
+            done = !request.replies;
+        }
+        else if (request.replies && (long) (millis() - request.replyAt) >= 0) {
+            if (pool.release(request.timeout))
+                answered++;
+            else
+                lateReplies++;
+            done = true;
+        }
+        if (done) requests[i--] = requests[--requestCount];
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+    randomSeed(analogRead(A0));
+}
+
+void loop() {
+    if (sendTimer.TRIGGERED) sendRequest();
+    checkRequests();
+
+    if (reportTimer.TRIGGERED) {
+        Serial.print(F("Answered "));
+        Serial.print(answered);
+        Serial.print(F(", timed out "));
+        Serial.print(timedOut);
+        Serial.print(F(", late replies caught "));
+        Serial.print(lateReplies);
+        Serial.print(F(", free timers "));
+        Serial.print(pool.getFree());
+        Serial.print(F(" of "));
+        Serial.println(pool.getCapacity());
+    }
+}
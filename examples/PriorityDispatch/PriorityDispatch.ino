@@ -0,0 +1,84 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotDispatcher.h>
+
+/*
+ * This sketch overloads the loop on purpose and lets BlockNotDispatcher sort it out.
+ *
+ * The control timer runs a (pretend) motor control loop every 2 milliseconds and has to be on
+ * time. The display, logging and network handlers all take a few milliseconds each, and now and
+ * then they all come due together - if they ran one after the other, the control loop would be
+ * left waiting for more than 15 milliseconds.
+ *
+ * With the dispatcher, every handler gets a priority and the loop pass gets a budget of 3
+ * milliseconds. The control handler always goes first, and once the budget is spent, whatever
+ * is left waits for the next pass. Every two seconds the sketch prints how many times the control
+ * handler ran, how many handlers had to wait, and the longest a single pass took.
+ *
+ * A handler is never interrupted, so the worst gap you will see is about the length of the
+ * slowest handler (the network one here) instead of all of them added together. If that is
+ * still too long, break the slow work up into smaller steps.
+ */
+
+#define BUDGET_MICROS 3000
+
+BlockNot controlTimer(2);
+BlockNot displayTimer(100);
+BlockNot logTimer(250);
+BlockNot networkTimer(500);
+BlockNot reportTimer(2, SECONDS);
+
+BlockNotDispatcher dispatcher(BUDGET_MICROS);
+
+unsigned long controlRuns = 0;
+unsigned long worstGap = 0;
+unsigned long lastControl = 0;
+
+void control(BlockNot &) {
+    const unsigned long now = micros();
+    if (lastControl != 0 && now - lastControl > worstGap) worstGap = now - lastControl;
+    lastControl = now;
+    controlRuns++;
+}
+
+void drawDisplay(BlockNot &) {
+    delay(4);
+}
+
+void writeLog(BlockNot &) {
+    delay(5);
+}
+
+void talkToNetwork(BlockNot &) {
+    delay(7);
+}
+
+void setup() {
+    Serial.begin(115200);
+    dispatcher.add(controlTimer, control, PRIORITY_HIGH);
+    dispatcher.add(displayTimer, drawDisplay, PRIORITY_NORMAL);
+    dispatcher.add(networkTimer, talkToNetwork, PRIORITY_NORMAL);
+    dispatcher.add(logTimer, writeLog, PRIORITY_LOW);
+    RESET_TIMERS;
+}
+
+void loop() {
+    dispatcher.dispatch();
+
+    if (reportTimer.TRIGGERED) {
+        Serial.print(F("Control ran "));
+        Serial.print(controlRuns);
+        Serial.print(F(" times, worst gap "));
+        Serial.print(worstGap);
+        Serial.print(F(" us, "));
+        Serial.print(dispatcher.getHandled());
+        Serial.print(F(" handlers ran, "));
+        Serial.print(dispatcher.getDeferred());
+        Serial.print(F(" waited, longest pass "));
+        Serial.print(dispatcher.getLongestPass());
+        Serial.println(F(" us"));
+        controlRuns = 0;
+        worstGap = 0;
+        dispatcher.resetCounters();
+    }
+}
@@ -0,0 +1,56 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotRateMeter.h>
+
+/*
+ * This sketch measures a flow meter and a fan tachometer with BlockNotRateMeter, each from its
+ * own interrupt.
+ *
+ * Connect the pulse output of a flow sensor to pin 2 and the tach wire of a PC fan to pin 3
+ * (with a pull-up, the tach output is open collector). The interrupts do nothing more than
+ * record() a pulse, and once a second the sketch prints the flow in liters per minute and the
+ * fan speed in RPM.
+ *
+ * The flow meter looks at the last two seconds and the fan at the last second. Both windows
+ * slide along with time, so the numbers change smoothly instead of jumping every time a window
+ * ends, and neither meter needs its own timer in the sketch. A meter that has just started
+ * reads low until a whole window has gone by.
+ *
+ * The sensor constants below are for a common YF-S201 flow sensor (7.5 pulses per second for
+ * each liter per minute) and a fan that pulses twice per turn - change them to suit yours.
+ */
+
+#define FLOW_PIN            2
+#define FAN_PIN             3
+#define PULSES_PER_LITER    450.0
+#define PULSES_PER_TURN     2.0
+
+BlockNotRateMeter flowMeter(2, SECONDS);
+BlockNotRateMeter fanMeter(1, SECONDS);
+BlockNot printTimer(1, SECONDS);
+
+void flowPulse() {
+    flowMeter.record();
+}
+
+void fanPulse() {
+    fanMeter.record();
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(FLOW_PIN, INPUT_PULLUP);
+    pinMode(FAN_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(FLOW_PIN), flowPulse, FALLING);
+    attachInterrupt(digitalPinToInterrupt(FAN_PIN), fanPulse, FALLING);
+}
+
+void loop() {
+    if (printTimer.TRIGGERED) {
+        Serial.print(F("Flow: "));
+        Serial.print(flowMeter.getRate(MINUTES) / PULSES_PER_LITER, 2);
+        Serial.print(F(" L/min   Fan: "));
+        Serial.print(fanMeter.getRate(MINUTES) / PULSES_PER_TURN, 0);
+        Serial.println(F(" RPM"));
+    }
+}
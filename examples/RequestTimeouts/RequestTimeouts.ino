@@ -0,0 +1,74 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotTimeoutSet.h>
+
+/*
+ * This sketch keeps track of many outstanding requests at once with a BlockNotTimeoutSet,
+ * the way a protocol layer would, instead of a timer for each request.
+ *
+ * Every 20 milliseconds the sketch sends a (pretend) request with the next sequence number
+ * and adds a 250 millisecond timeout for it, keyed by that number. Replies come in on their
+ * own - here, every 25 milliseconds for a random one of the last 16 requests, the way replies
+ * trickle back over a busy link - and each one cancels its timeout by sequence number. A reply for a
+ * request that already timed out, or was already answered, finds nothing to cancel.
+ *
+ * The loop asks the set for expired requests with a while loop, which only ever looks at
+ * the ones that are actually due, so it does the same small amount of work whether there
+ * are three requests out or three hundred. Once a second it prints how many requests were
+ * answered and how many timed out.
+ *
+ * The set holds 32 timeouts. To keep hundreds of requests in flight, build with a larger
+ * BLOCKNOT_TIMEOUTS, for example -D BLOCKNOT_TIMEOUTS=512.
+ */
+
+#define TIMEOUT_MS  250
+
+BlockNotTimeoutSet timeouts;
+BlockNot sendTimer(20);
+BlockNot replyTimer(25);
+BlockNot reportTimer(1, SECONDS);
+
+uint32_t nextSequence = 1;
+unsigned long answered = 0;
+unsigned long timedOut = 0;
+unsigned long notFound = 0;
+
+void sendRequest() {
+    if (timeouts.add(nextSequence, TIMEOUT_MS))
+        nextSequence++;
+}
+
+void receiveReply() {
+    // A reply to one of the last 16 requests
+    if (nextSequence < 17) return;
+    const uint32_t sequence = nextSequence - 1 - random(16);
+    if (timeouts.cancel(sequence))
+        answered++;
+    else
+        notFound++;
+}
+
+void setup() {
+    Serial.begin(115200);
+    randomSeed(analogRead(A0));
+}
+
+void loop() {
+    if (sendTimer.TRIGGERED) sendRequest();
+    if (replyTimer.TRIGGERED) receiveReply();
+
+    uint32_t sequence;
+    while (timeouts.expired(sequence))
+        timedOut++;
+
+    if (reportTimer.TRIGGERED) {
+        Serial.print(F("Answered "));
+        Serial.print(answered);
+        Serial.print(F(", timed out "));
+        Serial.print(timedOut);
+        Serial.print(F(", late or repeated replies "));
+        Serial.print(notFound);
+        Serial.print(F(", waiting on "));
+        Serial.println(timeouts.getCount());
+    }
+}
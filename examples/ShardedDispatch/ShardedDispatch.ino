@@ -0,0 +1,95 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotShard.h>
+
+/*
+ * This sketch benchmarks sharded timer dispatch with std::thread on Linux, using an
+ * Arduino API host core such as EpoxyDuino.
+ *
+ * Every timer lives in exactly one shard, and only the thread that owns the shard ever
+ * checks those timers, so no timer is touched by two threads at once. When a timer
+ * triggers, its handler goes into the shard's ready queue. Each thread runs its own
+ * handlers first, and when it has nothing left to do, it steals ready handlers from the
+ * other shards.
+ *
+ * To show the stealing at work, all of the timers are put on shard 0 and every handler
+ * burns a little CPU time. With one thread, shard 0 has to do everything. With more
+ * threads, the other threads steal handlers from shard 0 and the number of handlers run
+ * per second goes up with the number of cores you have.
+ *
+ * On a dual core RP2040 or ESP32, you would do the same thing without std::thread by
+ * calling shards.dispatch(0) in loop() and shards.dispatch(1) in the loop on the second core.
+ */
+
+#if defined(__linux__) && defined(BLOCKNOT_SHARDS)
+
+#include <thread>
+
+#define TIMERS          16
+#define BENCHMARK_MS    1000
+#define WORK            20000
+
+BlockNot *timers[TIMERS];
+BlockNot benchmarkTimer(BENCHMARK_MS);
+volatile unsigned long workResult;
+
+void busyHandler(BlockNot &) {
+    unsigned long result = 0;
+    for (unsigned long i = 0; i < WORK; i++) result += i * i;
+    workResult = result;
+}
+
+unsigned long benchmark(const uint8_t cores) {
+    BlockNotShards shards(cores);
+    for (uint8_t i = 0; i < TIMERS; i++) {
+        timers[i]->reset();
+        shards.add(0, *timers[i], busyHandler);
+    }
+    std::atomic<bool> running(true);
+    std::thread threads[BLOCKNOT_MAX_SHARDS];
+    for (uint8_t core = 0; core < shards.getCores(); core++) {
+        threads[core] = std::thread([&shards, &running, core]() {
+            while (running) shards.dispatch(core);
+        });
+    }
+    benchmarkTimer.RESET;
+    while (!benchmarkTimer.HAS_TRIGGERED) {
+        std::this_thread::yield();
+    }
+    running = false;
+    unsigned long handled = 0;
+    unsigned long stolen = 0;
+    for (uint8_t core = 0; core < shards.getCores(); core++) {
+        threads[core].join();
+        handled += shards.shard(core).getHandled();
+        stolen += shards.shard(core).getStolen();
+    }
+    Serial.println(String(shards.getCores()) + " core(s): " + String(handled * 1000UL / BENCHMARK_MS) + " handlers per second, " + String(stolen) + " stolen");
+    return handled;
+}
+
+void setup() {
+    Serial.begin(115200);
+    for (uint8_t i = 0; i < TIMERS; i++) {
+        timers[i] = new BlockNot(10, MICROSECONDS);
+    }
+    Serial.println(String(std::thread::hardware_concurrency()) + " hardware threads available");
+    for (uint8_t cores = 1; cores <= BLOCKNOT_MAX_SHARDS; cores++) {
+        benchmark(cores);
+    }
+}
+
+void loop() {
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println(F("This benchmark needs Linux and std::thread"));
+}
+
+void loop() {
+}
+
+#endif
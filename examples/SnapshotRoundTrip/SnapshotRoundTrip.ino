@@ -0,0 +1,105 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotSimulator.h>
+
+/*
+ * This sketch checks that a snapshot of your timers comes back exactly the way it went in,
+ * using nothing but a plain array in RAM. It is the same round trip the DeepSleepSnapshot
+ * example makes through RTC memory, minus the sleep, so it runs anywhere - on a board, or on
+ * a Linux machine under an Arduino API host core (EpoxyDuino for example), which makes it
+ * easy to run as a regression check.
+ *
+ * The timers run in virtual time with BlockNotSimulator, so every number is exact and the
+ * result is the same on every run. The sketch:
+ *
+ *  - lets the timers run for a while, then saves them all with snapshotAll()
+ *  - scrambles them, as waking up from deep sleep would
+ *  - restores them with restoreAll() and 1.5 seconds of "sleep" added to the running timers
+ *  - checks the elapsed time, duration, base units and running state of each one, along with
+ *    the slack, the overrun policy and its counts, and a duration that was set in cycles
+ *  - damages the base unit and the overrun policy in a copy of the snapshot and checks that
+ *    restoreAll() refuses it
+ *
+ * Each check prints PASS or FAIL, followed by the overall result.
+ */
+
+#define SLEPT_MILLIS 1500UL
+#define CYCLE_HZ     100000000UL
+
+BlockNot milliTimer(5, SECONDS);
+BlockNot microTimer(750000, MICROSECONDS);
+BlockNot stoppedTimer(3000);
+BlockNot burstTimer(200);
+BlockNot cycleTimer(1000);
+
+uint8_t snapshot[BLOCKNOT_SNAPSHOT_SIZE(5)];
+bool allPassed = true;
+
+void check(const char *name, const bool passed) {
+    Serial.print(passed ? F("PASS  ") : F("FAIL  "));
+    Serial.println(name);
+    if (!passed) allPassed = false;
+}
+
+void setup() {
+    Serial.begin(115200);
+    BlockNotSimulator::begin();
+    BlockNot::setCycleFrequency(CYCLE_HZ);
+    microTimer.setSlack(2000);
+    burstTimer.setOverrunPolicy(OVERRUN_BURST, 3);
+    cycleTimer.setDuration(250000000UL, CYCLES);    // 2.5 seconds at 100 MHz
+    RESET_TIMERS;
+
+    BlockNotSimulator::advance(1200 * SIM_MICROS_PER_MILLI);
+    stoppedTimer.STOP;
+    burstTimer.TRIGGERED;                           // 6 periods went by - 5 overruns, 3 of them queued
+    BlockNotSimulator::advance(300 * SIM_MICROS_PER_MILLI);
+
+    const size_t size = BlockNot::snapshotAll(snapshot, sizeof(snapshot));
+    check("snapshotAll() fills the buffer", size == sizeof(snapshot));
+
+    // Scramble everything the snapshot is supposed to bring back
+    BlockNotSimulator::advance(10 * SIM_MICROS_PER_SECOND);
+    RESET_TIMERS;
+    milliTimer.switchTo(MICROSECONDS);
+    microTimer.setDuration(1);
+    stoppedTimer.START();
+    microTimer.setSlack(0);
+    burstTimer.setOverrunPolicy(OVERRUN_DEFAULT);
+    burstTimer.clearOverrunCount();
+    cycleTimer.setDuration(1);
+
+    check("restoreAll() accepts the snapshot", BlockNot::restoreAll(snapshot, size, SLEPT_MILLIS));
+    check("running timer in seconds keeps its duration and units", milliTimer.DURATION == 5 && milliTimer.getBaseUnits() == SECONDS);
+    check("running timer in seconds has the sleep added", milliTimer.getRawElapsed() == 1500 + SLEPT_MILLIS);
+    check("microsecond timer keeps its duration", microTimer.DURATION == 750000);
+    check("microsecond timer has the sleep added", microTimer.ELAPSED == 1500000 + SLEPT_MILLIS * 1000UL);
+    check("microsecond timer triggers after the sleep", microTimer.HAS_TRIGGERED);
+    check("stopped timer is still stopped", stoppedTimer.ISSTOPPED);
+    stoppedTimer.START();
+    check("stopped timer did not pass time while asleep", stoppedTimer.ELAPSED == 1200);
+    check("slack comes back", microTimer.getRawSlack() == 2000);
+    check("overrun policy comes back", burstTimer.getOverrunPolicy() == OVERRUN_BURST);
+    check("overrun count comes back", burstTimer.getOverrunCount() == 5);
+    check("queued catch-up triggers come back", burstTimer.getPendingCatchUps() == 3);
+    check("duration set in cycles comes back", cycleTimer.DURATION == 2500);
+    BlockNot::setCycleFrequency(2 * CYCLE_HZ);
+    check("duration set in cycles is still kept in cycles", cycleTimer.DURATION == 1250);
+    BlockNot::setCycleFrequency(CYCLE_HZ);
+
+    uint8_t damaged[sizeof(snapshot)];
+    memcpy(damaged, snapshot, sizeof(snapshot));
+    damaged[BLOCKNOT_SNAPSHOT_HEADER_SIZE + BLOCKNOT_SNAPSHOT_RECORD_SIZE + 1] = 0xFF;
+    milliTimer.RESET;
+    check("restoreAll() refuses a snapshot with a bad base unit", !BlockNot::restoreAll(damaged, size, SLEPT_MILLIS));
+    check("a refused snapshot leaves the timers alone", milliTimer.getRawElapsed() == 0);
+    memcpy(damaged, snapshot, sizeof(snapshot));
+    damaged[BLOCKNOT_SNAPSHOT_HEADER_SIZE + 3 * BLOCKNOT_SNAPSHOT_RECORD_SIZE + 26] = 0xFF;
+    check("restoreAll() refuses a snapshot with a bad overrun policy", !BlockNot::restoreAll(damaged, size, SLEPT_MILLIS));
+
+    BlockNotSimulator::end();
+    Serial.println(allPassed ? F("\nAll checks passed") : F("\nSome checks failed"));
+}
+
+void loop() {
+}
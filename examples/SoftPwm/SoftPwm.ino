@@ -0,0 +1,66 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotPwm.h>
+
+/*
+ * This sketch fades eight LEDs with software PWM, each one a little behind the one before it,
+ * and moves a servo back and forth, all on ordinary pins.
+ *
+ * The usual way to do software PWM is one MICROSECONDS timer per pin, and the more pins you
+ * add, the more timers there are to check and the more the pulses wobble. BlockNotPwm runs
+ * every channel from one timer. All of the channels go high at the start of the period, and
+ * every place where one or more of them has to go low is kept in a sorted list, so the work
+ * depends on how many different pulse widths there are, not on how many pins.
+ *
+ * When you change a pulse, the change waits for the start of the next period, so you never
+ * get a pulse that is cut short or doubled up in the middle of a change.
+ *
+ * The LEDs run at 500 Hz (a 2000 microsecond period). Servos want a 1000 to 2000 microsecond
+ * pulse every 20 milliseconds, so the servo gets an engine of its own.
+ */
+
+#define LED_COUNT   8
+#define SERVO_PIN   12
+
+const uint8_t ledPins[LED_COUNT] = {2, 3, 4, 5, 6, 7, 8, 9};
+
+BlockNotPwm leds(2000);
+BlockNotPwm servo(20000);
+BlockNot fadeTimer(10);
+BlockNot sweepTimer(20);
+
+uint8_t phase = 0;
+unsigned long servoPulse = 1000;
+int servoStep = 10;
+
+uint8_t triangle(const uint8_t value) {
+    return (value < 128) ? value * 2 : (255 - value) * 2;
+}
+
+void setup() {
+    for (uint8_t led = 0; led < LED_COUNT; led++) {
+        leds.add(ledPins[led]);
+    }
+    servo.add(SERVO_PIN, servoPulse);
+    leds.begin();
+    servo.begin();
+}
+
+void loop() {
+    leds.poll();
+    servo.poll();
+
+    if (fadeTimer.TRIGGERED) {
+        phase++;
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            leds.setDuty(led, triangle(phase + led * 32));
+        }
+    }
+
+    if (sweepTimer.TRIGGERED) {
+        if (servoPulse <= 1000) servoStep = 10;
+        if (servoPulse >= 2000) servoStep = -10;
+        servoPulse += servoStep;
+        servo.setPulse(0, servoPulse);
+    }
+}
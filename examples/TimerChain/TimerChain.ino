@@ -0,0 +1,64 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotChain.h>
+
+/*
+ * This sketch runs a little pump cycle with BlockNotChain instead of nested if statements.
+ *
+ *  - warmUp runs once for 3 seconds
+ *  - when warmUp triggers, it starts pumpRun and the LED starts blinking
+ *  - when pumpRun triggers 5 seconds later, the blinking stops and warmUp starts over
+ *
+ * Written out by hand, that would be a stack of "if (warmUp.TRIGGERED) pumpRun.START(WITH_RESET)"
+ * blocks, and every one of those timers would be checked on every pass through the loop, even
+ * the ones that are stopped. With the chain, the links are described once in setup() and
+ * chain.poll() only checks the timers that are running.
+ */
+
+#define PUMP_PIN 7
+
+BlockNot warmUp(3, SECONDS);
+BlockNot pumpRun(5, SECONDS, STOPPED);
+BlockNot blinkTimer(250, STOPPED);
+
+BlockNotChain chain;
+
+bool ledOn = false;
+
+void warmedUp(BlockNot &) {
+    Serial.println(F("Warmed up, pump on"));
+    digitalWrite(PUMP_PIN, HIGH);
+}
+
+void pumpDone(BlockNot &) {
+    Serial.println(F("Pump off, warming up again"));
+    digitalWrite(PUMP_PIN, LOW);
+    digitalWrite(LED_BUILTIN, LOW);
+    ledOn = false;
+}
+
+void blink(BlockNot &) {
+    ledOn = !ledOn;
+    digitalWrite(LED_BUILTIN, ledOn ? HIGH : LOW);
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(PUMP_PIN, OUTPUT);
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    chain.add(warmUp, CHAIN_ONE_SHOT, warmedUp);
+    chain.add(pumpRun, CHAIN_ONE_SHOT, pumpDone);
+    chain.add(blinkTimer, CHAIN_REPEAT, blink);
+
+    chain.link(warmUp, CHAIN_START, pumpRun);
+    chain.link(warmUp, CHAIN_START, blinkTimer);
+    chain.link(pumpRun, CHAIN_STOP, blinkTimer);
+    chain.link(pumpRun, CHAIN_START, warmUp);
+
+    Serial.println(F("Warming up"));
+}
+
+void loop() {
+    chain.poll();
+}
@@ -0,0 +1,51 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch prints a small dashboard of every timer, the kind of thing you might draw on a
+ * display every frame.
+ *
+ * Getting the elapsed time, the remaining time and whether a timer is due usually takes three
+ * calls - ELAPSED, REMAINING and HAS_TRIGGERED - and each one of them reads the clock and
+ * converts the answer into the timer's base units. STATUS gets all of it from a single clock
+ * read and hands it back in raw ticks (micros() for MICROSECONDS timers, millis() for all
+ * others) without any conversion, which is a lot cheaper when you are doing it for every
+ * timer, over and over.
+ *
+ * The dashboard walks through every timer with forEachTimer(), so any timer you add shows up
+ * on its own, whether it is an ordinary timer or one declared with BLOCKNOT_STATIC().
+ */
+
+BlockNot pumpTimer(4, SECONDS);
+BlockNot fanTimer(2500);
+BlockNot sensorTimer(750);
+BlockNot stepTimer(150000, MICROSECONDS);
+BlockNot frameTimer(1, SECONDS);
+
+uint8_t number = 0;
+
+void printStatus(BlockNot &timer) {
+    const BlockNotStatus status = timer.STATUS;
+    Serial.print(String(number++) + "\t");
+    Serial.print(String(status.elapsed) + "\t");
+    Serial.print(String(status.remaining) + "\t");
+    Serial.print(timer.getBaseUnits() == MICROSECONDS ? "us\t" : "ms\t");
+    Serial.println(!status.running ? "stopped" : status.due ? "due" : "running");
+}
+
+void setup() {
+    Serial.begin(115200);
+    fanTimer.STOP;
+}
+
+void loop() {
+    pumpTimer.TRIGGERED;
+    sensorTimer.TRIGGERED;
+    stepTimer.TRIGGERED;
+
+    if (frameTimer.TRIGGERED) {
+        Serial.println(F("\nTimer\tElapsed\tLeft\tTicks\tState"));
+        number = 0;
+        BlockNot::forEachTimer(printStatus);
+    }
+}
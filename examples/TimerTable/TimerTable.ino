@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch declares its timers with BLOCKNOT_STATIC() so the linker gathers them into a
+ * table, instead of each timer adding itself to the global reset list when it is constructed.
+ *
+ * Three LEDs blink at different rates, and every ten seconds all of the timers are reset with
+ * RESET_TIMERS so the LEDs line back up. Once a second, the sketch walks every timer with
+ * forEachTimer() and prints how long each one has left, along with how many of them came from
+ * the table.
+ *
+ * The table is on for Linux, and for other GCC boards built with -D BLOCKNOT_USE_TIMER_SECTION
+ * once you have checked that the linker script keeps the section. Everywhere else,
+ * BLOCKNOT_STATIC() makes ordinary timers, and the sketch runs the same way - the table count
+ * is just zero. Where the table is on, build with -D BLOCKNOT_NO_TIMER_LIST to drop the global
+ * reset list altogether and save the pointer it costs in every timer.
+ */
+
+#define LED_ONE     4
+#define LED_TWO     5
+#define LED_THREE   6
+
+BLOCKNOT_STATIC(ledOneTimer, 250);
+BLOCKNOT_STATIC(ledTwoTimer, 400);
+BLOCKNOT_STATIC(ledThreeTimer, 650);
+BLOCKNOT_STATIC(reportTimer, 1, SECONDS);
+BLOCKNOT_STATIC(lineUpTimer, 10, SECONDS);
+
+void flip(const uint8_t pin) {
+    digitalWrite(pin, !digitalRead(pin));
+}
+
+void printTimeLeft(BlockNot &timer) {
+    Serial.print(' ');
+    Serial.print(timer.getTimeUntilTrigger());
+}
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(LED_ONE, OUTPUT);
+    pinMode(LED_TWO, OUTPUT);
+    pinMode(LED_THREE, OUTPUT);
+    Serial.print(BlockNot::getTableCount());
+    Serial.print(F(" of "));
+    Serial.print(BlockNot::getTimerCount());
+    Serial.println(F(" timers are in the table"));
+    RESET_TIMERS;
+}
+
+void loop() {
+    if (ledOneTimer.TRIGGERED) flip(LED_ONE);
+    if (ledTwoTimer.TRIGGERED) flip(LED_TWO);
+    if (ledThreeTimer.TRIGGERED) flip(LED_THREE);
+
+    if (lineUpTimer.TRIGGERED) {
+        digitalWrite(LED_ONE, LOW);
+        digitalWrite(LED_TWO, LOW);
+        digitalWrite(LED_THREE, LOW);
+        RESET_TIMERS;
+    }
+
+    if (reportTimer.TRIGGERED) {
+        Serial.print(F("Time left:"));
+        BlockNot::forEachTimer(printTimeLeft);
+        Serial.println();
+    }
+}
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+
+/*
+ * This sketch measures how long it takes to check a timer, so you can see what a poll costs
+ * on your board.
+ *
+ * Each timer keeps its duration as a whole number of ticks, so checking whether it triggered
+ * is one subtraction and one compare, with no floating point. Older versions kept only the
+ * duration in floating point seconds and converted it on every check. The sketch times both
+ * compares side by side - the millis() compare against a whole number of ticks that the check
+ * does now, and the same compare against a duration read out of a cTime the way it used to be.
+ *
+ * Then it checks a timer that is nowhere near done 10,000 times in a row for each base unit,
+ * and does the same with getTimeUntilTrigger(). Every five seconds it prints the average cost
+ * of one call in nanoseconds.
+ *
+ * On boards without a floating point unit, like the Uno or the Cortex-M0 boards, this is where
+ * the difference shows up the most, since the floating point conversion can cost more than
+ * reading the clock.
+ */
+
+#define CHECKS 10000UL
+
+BlockNot milliTimer(1, MINUTES);
+BlockNot microTimer(1000000, MICROSECONDS);
+BlockNot cycleTimer(1000000, CYCLES);
+BlockNot reportTimer(5, SECONDS);
+
+BlockNot::cTime floatDuration;              // one minute, kept the way durations used to be
+const unsigned long wholeDuration = 60000UL;
+
+volatile unsigned long sink = 0;
+
+unsigned long nanosPerCall(const unsigned long startMicros) {
+    return (micros() - startMicros) * 1000UL / CHECKS;
+}
+
+unsigned long timeTriggered(BlockNot &timer) {
+    const unsigned long start = micros();
+    unsigned long total = 0;
+    for (unsigned long i = 0; i < CHECKS; i++)
+        total += timer.TRIGGERED;
+    sink = total;
+    return nanosPerCall(start);
+}
+
+unsigned long timeRemaining(BlockNot &timer) {
+    const unsigned long start = micros();
+    unsigned long total = 0;
+    for (unsigned long i = 0; i < CHECKS; i++)
+        total += timer.getTimeUntilTrigger();
+    sink = total;
+    return nanosPerCall(start);
+}
+
+unsigned long timeWholeCompare() {
+    const unsigned long last = millis();
+    const unsigned long start = micros();
+    unsigned long total = 0;
+    for (unsigned long i = 0; i < CHECKS; i++)
+        total += (millis() - last >= wholeDuration);
+    sink = total;
+    return nanosPerCall(start);
+}
+
+unsigned long timeFloatCompare() {
+    const unsigned long last = millis();
+    const unsigned long start = micros();
+    unsigned long total = 0;
+    for (unsigned long i = 0; i < CHECKS; i++)
+        total += (millis() - last >= static_cast<unsigned long>(floatDuration.millis));
+    sink = total;
+    return nanosPerCall(start);
+}
+
+void printNanos(const unsigned long nanos) {
+    Serial.print(nanos);
+    Serial.println(F(" ns"));
+}
+
+void setup() {
+    Serial.begin(115200);
+    floatDuration.millis = wholeDuration;
+}
+
+void loop() {
+    if (reportTimer.TRIGGERED) {
+        Serial.print(F("Compare, whole ticks (now):    "));
+        printNanos(timeWholeCompare());
+        Serial.print(F("Compare, floating point (old): "));
+        printNanos(timeFloatCompare());
+        Serial.print(F("TRIGGERED (MINUTES):           "));
+        printNanos(timeTriggered(milliTimer));
+        Serial.print(F("TRIGGERED (MICROSECONDS):      "));
+        printNanos(timeTriggered(microTimer));
+        Serial.print(F("TRIGGERED (CYCLES):            "));
+        printNanos(timeTriggered(cycleTimer));
+        Serial.print(F("getTimeUntilTrigger (MINUTES): "));
+        printNanos(timeRemaining(milliTimer));
+        Serial.println();
+    }
+}
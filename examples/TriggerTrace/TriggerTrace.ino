@@ -0,0 +1,76 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotTrace.h>
+
+/*
+ * This sketch records five seconds of timer activity with BlockNotTrace and then prints the
+ * capture, so you can see exactly when each timer fired and how late it was.
+ *
+ * The slowWork timer blocks for a while every time it runs (like a slow sensor read would),
+ * and that makes the other timers late. In the serial output you will see the lateness for
+ * each trigger - the time past its duration that the timer was actually noticed.
+ *
+ * Send c to print the capture as Chrome trace JSON, or v to print it as a VCD file. Copy
+ * everything from the first { to the last } into a file ending in .json and open it at
+ * https://ui.perfetto.dev, or copy everything from $timescale to the end into a file ending
+ * in .vcd and open it with GTKWave or PulseView, right next to your logic analyzer capture.
+ */
+
+#define CAPTURE_SECONDS 5
+
+BlockNot blinkTimer(250);
+BlockNot sampleTimer(100);
+BlockNot slowWork(1300);
+BlockNot captureTimer(CAPTURE_SECONDS, SECONDS);
+
+bool ledOn = false;
+
+void setup() {
+    Serial.begin(115200);
+    pinMode(LED_BUILTIN, OUTPUT);
+    BlockNotTrace::name(blinkTimer, "blink");
+    BlockNotTrace::name(sampleTimer, "sample");
+    BlockNotTrace::name(slowWork, "slowWork");
+    BlockNotTrace::name(captureTimer, "capture");
+    RESET_TIMERS;
+    BlockNotTrace::begin();
+    Serial.println(F("Capturing..."));
+}
+
+void loop() {
+    if (blinkTimer.TRIGGERED) {
+        ledOn = !ledOn;
+        digitalWrite(LED_BUILTIN, ledOn ? HIGH : LOW);
+    }
+
+    if (sampleTimer.TRIGGERED) {
+        analogRead(A0);
+    }
+
+    if (slowWork.TRIGGERED) {
+        delay(120);
+    }
+
+    if (BlockNotTrace::isActive() && captureTimer.TRIGGERED) {
+        BlockNotTrace::end();
+        Serial.print(BlockNotTrace::getCount());
+        Serial.print(F(" events captured, "));
+        Serial.print(BlockNotTrace::getOverwritten());
+        Serial.println(F(" overwritten. Send c for Chrome trace JSON or v for VCD."));
+        BlockNotTraceEvent event;
+        for (uint16_t index = 0; BlockNotTrace::getEvent(index, event); index++) {
+            if (event.event != TRACE_TRIGGER || event.lateness < 1000) continue;
+            Serial.print(F("Timer "));
+            Serial.print(event.timer);
+            Serial.print(F(" triggered "));
+            Serial.print(event.lateness);
+            Serial.println(F(" us late"));
+        }
+    }
+
+    if (Serial.available()) {
+        const char command = static_cast<char>(Serial.read());
+        if (command == 'c') BlockNotTrace::writeChromeTrace(Serial);
+        if (command == 'v') BlockNotTrace::writeVcd(Serial);
+    }
+}
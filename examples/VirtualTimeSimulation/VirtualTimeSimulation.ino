@@ -0,0 +1,70 @@
+#include <Arduino.h>
+#include <BlockNot.h>
+#include <BlockNotSimulator.h>
+
+/*
+ * This sketch runs three days worth of timer activity in virtual time, and it
+ * crosses a millis() rollover and dozens of micros() rollovers along the way.
+ *
+ * The MillisRolloverTest example proves rollover on real hardware by pushing millis()
+ * close to the rollover point and then waiting for it to happen. That works, but you have
+ * to sit there and watch it. BlockNotSimulator replaces the clock that BlockNot uses with
+ * a virtual clock, and instead of letting time pass, it jumps the clock straight to the
+ * moment the next timer is due, runs your loop code once, and then jumps again.
+ *
+ * The virtual clock is started one hour before millis() rolls over, and it is kept as
+ * a 64 bit count of microseconds so millis() and micros() roll over at the same points
+ * they do on the real thing.
+ *
+ * At the end, the sketch compares the number of times each timer triggered with the
+ * number of times it should have triggered and prints how long the whole run took in
+ * real time. This runs fine on a board, and it also runs on a Linux machine under an
+ * Arduino API host core (EpoxyDuino for example), which is where it is most useful for
+ * long regression runs of your own timer schedules.
+ */
+
+#define SIMULATED_DAYS 3
+
+BlockNot fastTimer(250);
+BlockNot microTimer(2000000, MICROSECONDS);
+BlockNot secondsTimer(10, SECONDS);
+BlockNot minutesTimer(1, MINUTES);
+
+unsigned long fastCount = 0;
+unsigned long microCount = 0;
+unsigned long secondsCount = 0;
+unsigned long minutesCount = 0;
+
+void simulatedLoop() {
+    if (fastTimer.TRIGGERED) fastCount++;
+    if (microTimer.TRIGGERED) microCount++;
+    if (secondsTimer.TRIGGERED) secondsCount++;
+    if (minutesTimer.TRIGGERED) minutesCount++;
+}
+
+void report(const String &name, const unsigned long count, const uint64_t periodMicros) {
+    const unsigned long expected = (SIMULATED_DAYS * SIM_MICROS_PER_DAY) / periodMicros;
+    Serial.println(name + ": " + String(count) + " triggers, expected " + String(expected) + (count == expected ? " - PASS" : " - FAIL"));
+}
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println("Simulating " + String(SIMULATED_DAYS) + " days of timers...");
+
+    BlockNotSimulator::begin(4294967296000ULL - SIM_MICROS_PER_HOUR);
+    RESET_TIMERS;
+
+    const unsigned long realStart = millis();
+    const unsigned long wakeups = BlockNotSimulator::run(SIMULATED_DAYS * SIM_MICROS_PER_DAY, simulatedLoop);
+    const unsigned long realTime = millis() - realStart;
+    BlockNotSimulator::end();
+
+    report("fastTimer", fastCount, 250 * SIM_MICROS_PER_MILLI);
+    report("microTimer", microCount, 2 * SIM_MICROS_PER_SECOND);
+    report("secondsTimer", secondsCount, 10 * SIM_MICROS_PER_SECOND);
+    report("minutesTimer", minutesCount, SIM_MICROS_PER_MINUTE);
+    Serial.println("Loop ran " + String(wakeups) + " times in " + String(realTime) + " milliseconds of real time");
+}
+
+void loop() {
+}
@@ -18,9 +18,292 @@
  * Global Variables
  */
 
+#ifndef BLOCKNOT_NO_TIMER_LIST
 BlockNot *BlockNot::firstTimer = nullptr;
 BlockNot *BlockNot::currentTimer = nullptr;
+#endif
 BlockNotGlobal BlockNot::global = GLOBAL_RESET;
+BlockNotClock BlockNot::millisClock = nullptr;
+BlockNotClock BlockNot::microsClock = nullptr;
+bool BlockNot::coalescing = true;
+long BlockNot::clockPpb = 0;
+int32_t BlockNot::clockAdjust = 0;
+BlockNotTraceHook BlockNot::traceHook = nullptr;
+unsigned long BlockNot::cycleFrequency = 0;
+BlockNotWakeupSource BlockNot::wakeupSources[BLOCKNOT_WAKEUP_SOURCES] = {};
+const void *BlockNot::wakeupOwners[BLOCKNOT_WAKEUP_SOURCES] = {};
+uint8_t BlockNot::wakeupSourceCount = 0;
+
+/**
+ * Snapshot record layout (little endian, BLOCKNOT_SNAPSHOT_RECORD_SIZE bytes)
+ *
+ *  0  flags            bit0 running, bit1 onceTriggered, bit2 triggerOnNext,
+ *                      bit3 firstTriggerResponse, bit4 speedCompensation,
+ *                      bit5 duration kept in cycles
+ *  1  baseUnits
+ *  2  duration         raw ticks (micros for MICROSECONDS, cycles for CYCLES, millis otherwise),
+ *                      or cycles when bit5 is set
+ *  6  elapsed          raw ticks since the last reset, at the moment of the snapshot
+ * 10  missed           queued missed durations from triggeredOnDuration(ALL) or the overrun policy
+ * 14  stoppedReturnValue
+ * 18  lastDuration
+ * 22  compTime
+ * 26  overrunPolicy
+ * 27  overrunLimit
+ * 31  overrunCount
+ * 35  catchUpInterval  raw ticks between SPREAD catch-up triggers
+ * 39  sinceCatchUp     raw ticks since the last SPREAD catch-up trigger
+ * 43  slack            raw ticks
+ */
+
+#define SNAPSHOT_MAGIC_1    'B'
+#define SNAPSHOT_MAGIC_2    'N'
+#define FLAG_RUNNING        0x01
+#define FLAG_ONCE_TRIGGERED 0x02
+#define FLAG_TRIGGER_NEXT   0x04
+#define FLAG_FIRST_RESPONSE 0x08
+#define FLAG_SPEED_COMP     0x10
+#define FLAG_IN_CYCLES      0x20
+
+/**
+ * Clock rate correction
+ *
+ * The corrected clock is worked out from an anchor - a raw reading and the corrected time
+ * that goes with it - without writing anything back:
+ *
+ *      out = anchor.out + delta + (delta * adjust + anchor.fraction) / 2^32
+ *
+ * where delta is the raw ticks since the anchor and adjust is the rate correction as a
+ * signed fraction of 2^32. Reads from interrupts and other cores can't get in each other's
+ * way, and since only deltas are used, the corrected clock rolls over cleanly with the raw one.
+ *
+ * A delta can only be scaled while it fits in 32 bits, so once the raw clock gets a quarter
+ * of the way around from the anchor, the next read moves the anchor up to where it is, with
+ * the part of a tick left over in fraction so no time is lost. There are two anchors and
+ * the new one is written into the one that isn't in use before readers are switched over,
+ * so a read that is part way through never sees half of an anchor. Whoever gets the lock
+ * moves it, and anyone else just keeps reading from the old one, which gives the same answer.
+ */
+
+#if __has_include(<atomic>)
+#define CLOCK_ATOMIC
+#include <atomic>
+#endif
+
+#define REANCHOR_TICKS 0x40000000UL
+
+struct ClockAnchor {
+    unsigned long raw;
+    unsigned long out;
+    uint32_t fraction;
+};
+
+struct ClockCorrection {
+    ClockAnchor anchors[2];
+#ifdef CLOCK_ATOMIC
+    std::atomic<uint8_t> current;
+    std::atomic_flag moving;
+#else
+    volatile uint8_t current;
+    volatile bool moving;
+#endif
+};
+
+static ClockCorrection millisCorrection;
+static ClockCorrection microsCorrection;
+static volatile bool correctionActive = false;
+
+static const ClockAnchor &currentAnchor(const ClockCorrection &correction) {
+#ifdef CLOCK_ATOMIC
+    return correction.anchors[correction.current.load(std::memory_order_acquire)];
+#else
+    return correction.anchors[correction.current];
+#endif
+}
+
+static bool lockAnchor(ClockCorrection &correction) {
+#ifdef CLOCK_ATOMIC
+    return !correction.moving.test_and_set(std::memory_order_acquire);
+#else
+    BlockNotCritical critical;
+    if (correction.moving) return false;
+    correction.moving = true;
+    return true;
+#endif
+}
+
+static void moveAnchor(ClockCorrection &correction, const ClockAnchor &anchor) {
+    // Only ever called holding the lock, so nobody else is writing the spare anchor
+#ifdef CLOCK_ATOMIC
+    const uint8_t spare = correction.current.load(std::memory_order_relaxed) ^ 1;
+    correction.anchors[spare] = anchor;
+    correction.current.store(spare, std::memory_order_release);
+    correction.moving.clear(std::memory_order_release);
+#else
+    const uint8_t spare = correction.current ^ 1;
+    correction.anchors[spare] = anchor;
+    correction.current = spare;
+    correction.moving = false;
+#endif
+}
+
+static ClockAnchor anchorAt(const ClockAnchor &anchor, const unsigned long raw, const int32_t adjust) {
+    const uint32_t delta = static_cast<uint32_t>(raw - anchor.raw);
+    // With no correction left to apply the clock is only offset, and that needs no 64 bit math
+    if (adjust == 0) return {raw, static_cast<uint32_t>(anchor.out + delta), 0};
+    const int64_t scaled = static_cast<int64_t>(delta) * adjust + anchor.fraction;
+    const int64_t ticks = (scaled >= 0) ? (scaled >> 32) : -((-scaled + 0xFFFFFFFFLL) >> 32);
+    return {raw, static_cast<uint32_t>(anchor.out + delta + ticks), static_cast<uint32_t>(scaled - (ticks << 32))};
+}
+
+template<typename Advance>
+static unsigned long readAnchored(ClockCorrection &clock, const unsigned long raw, Advance advance) {
+    const ClockAnchor anchor = currentAnchor(clock);
+    const ClockAnchor now = advance(anchor, raw);
+    if (static_cast<uint32_t>(raw - anchor.raw) >= REANCHOR_TICKS && lockAnchor(clock))
+        moveAnchor(clock, now);
+    return now.out;
+}
+
+static unsigned long correctedClock(ClockCorrection &correction, const unsigned long raw, const int32_t adjust) {
+    return readAnchored(correction, raw, [adjust](const ClockAnchor &anchor, const unsigned long now) {
+        return anchorAt(anchor, now, adjust);
+    });
+}
+
+static bool anchorClock(ClockCorrection &correction, const unsigned long raw, const int32_t adjust) {
+    // Anchors the clock where it reads right now, and tells whether it is left offset from raw
+    while (!lockAnchor(correction)) {
+    }
+    const ClockAnchor now = correctionActive ? anchorAt(currentAnchor(correction), raw, adjust) : ClockAnchor{raw, raw, 0};
+    moveAnchor(correction, now);
+    return now.out != now.raw;
+}
+
+/**
+ * CPU cycle counters for CYCLES timers
+ *
+ *  Cortex-M3/M4/M7/M33 - the DWT cycle counter, switched on the first time it is read
+ *  Xtensa (ESP32, ESP8266) - the CCOUNT register
+ *  x86 Linux - rdtsc, cut down to 32 bits like the others
+ *
+ * Every counter is 32 bits, so it wraps after 2^32 cycles - about 18 seconds at 240 MHz
+ * and about 1.4 seconds at 3 GHz - and that is the longest a CYCLES timer can run.
+ *
+ * Everything else counts cycles from micros() at the cycle frequency, which keeps CYCLES
+ * timers working, just without the finer resolution.
+ */
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define BLOCKNOT_CYCLE_COUNTER
+#define DWT_CTRL    (*reinterpret_cast<volatile uint32_t *>(0xE0001000UL))
+#define DWT_CYCCNT  (*reinterpret_cast<volatile uint32_t *>(0xE0001004UL))
+#define DEMCR       (*reinterpret_cast<volatile uint32_t *>(0xE000EDFCUL))
+
+static bool cycleCounterOn = false;
+
+static uint32_t readCycleCounter() {
+    if (!cycleCounterOn) {
+        DEMCR |= (1UL << 24);   // TRCENA
+        DWT_CTRL |= 1UL;        // CYCCNTENA
+        cycleCounterOn = true;
+    }
+    return DWT_CYCCNT;
+}
+#elif defined(__XTENSA__)
+#define BLOCKNOT_CYCLE_COUNTER
+
+static uint32_t readCycleCounter() {
+    uint32_t count;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(count));
+    return count;
+}
+#elif defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+#define BLOCKNOT_CYCLE_COUNTER
+#include <x86intrin.h>
+
+static uint32_t readCycleCounter() {
+    return static_cast<uint32_t>(__rdtsc());
+}
+#endif
+
+#ifndef BLOCKNOT_CYCLE_FREQUENCY
+#ifdef F_CPU
+#define BLOCKNOT_CYCLE_FREQUENCY    F_CPU
+#else
+#define BLOCKNOT_CYCLE_FREQUENCY    0
+#endif
+#endif
+
+/*
+ * Cycles counted from micros() use the same kind of anchor as the clock correction, with
+ * the part of a cycle left over kept in fraction, so the count stays continuous through
+ * micros() rollover and can be read from interrupts and other cores. The anchor is moved
+ * whenever the frequency changes, so a new frequency only applies from then on.
+ */
+
+static ClockCorrection microsCycles;
+
+static ClockAnchor cycleAnchorAt(const ClockAnchor &anchor, const unsigned long micros, const unsigned long frequency) {
+    const uint64_t total = static_cast<uint64_t>(static_cast<uint32_t>(micros - anchor.raw)) * frequency + anchor.fraction;
+    return {micros, static_cast<uint32_t>(anchor.out + total / 1000000ULL), static_cast<uint32_t>(total % 1000000ULL)};
+}
+
+static uint32_t cyclesFromMicros(const unsigned long micros, const unsigned long frequency) {
+    return readAnchored(microsCycles, micros, [frequency](const ClockAnchor &anchor, const unsigned long now) {
+        return cycleAnchorAt(anchor, now, frequency);
+    });
+}
+
+static void anchorCycles(const unsigned long micros, const unsigned long frequency) {
+    while (!lockAnchor(microsCycles)) {
+    }
+    moveAnchor(microsCycles, cycleAnchorAt(currentAnchor(microsCycles), micros, frequency));
+}
+
+#ifdef BLOCKNOT_TIMER_SECTION
+/*
+ * The linker makes these up for any section whose name is a valid C name, marking where the
+ * BLOCKNOT_STATIC() entries start and stop. They are weak so a sketch without any still links.
+ */
+extern BlockNot *const __start_blocknot_timers[] __attribute__((weak));
+extern BlockNot *const __stop_blocknot_timers[] __attribute__((weak));
+#endif
+
+static void putLong(uint8_t *buffer, const unsigned long value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+    buffer[2] = (value >> 16) & 0xFF;
+    buffer[3] = (value >> 24) & 0xFF;
+}
+
+static unsigned long getLong(const uint8_t *buffer) {
+    return static_cast<unsigned long>(buffer[0]) |
+           static_cast<unsigned long>(buffer[1]) << 8 |
+           static_cast<unsigned long>(buffer[2]) << 16 |
+           static_cast<unsigned long>(buffer[3]) << 24;
+}
+
+static void putHeader(uint8_t *buffer, const uint8_t count) {
+    buffer[0] = SNAPSHOT_MAGIC_1;
+    buffer[1] = SNAPSHOT_MAGIC_2;
+    buffer[2] = BLOCKNOT_SNAPSHOT_VERSION;
+    buffer[3] = count;
+}
+
+static bool validHeader(const uint8_t *buffer, const size_t size) {
+    return buffer != nullptr &&
+           size >= BLOCKNOT_SNAPSHOT_HEADER_SIZE &&
+           buffer[0] == SNAPSHOT_MAGIC_1 &&
+           buffer[1] == SNAPSHOT_MAGIC_2 &&
+           buffer[2] == BLOCKNOT_SNAPSHOT_VERSION &&
+           size >= BLOCKNOT_SNAPSHOT_SIZE(buffer[3]);
+}
+
+static bool validRecord(const uint8_t *record) {
+    // Anything past the last base unit or policy can only come from a damaged or foreign snapshot
+    return record[1] <= static_cast<uint8_t>(CYCLES) && record[26] <= static_cast<uint8_t>(OVERRUN_COUNT_ONLY);
+}
 
 /**
  * Constructors
@@ -202,6 +485,26 @@ BlockNot::BlockNot(const unsigned long time, const unsigned long stoppedReturnVa
     if (global == GLOBAL_RESET) addToTimerList();
 }
 
+BlockNot::BlockNot(const BlockNotListing listing, const unsigned long time, const BlockNotState state) {
+    baseUnits = MILLISECONDS;
+    timerState = state;
+    if(timerState == STOPPED)
+        stop();
+    initDuration(time);
+    reset();
+    if (listing == BlockNotListing::listingListed) addToTimerList();
+}
+
+BlockNot::BlockNot(const BlockNotListing listing, const unsigned long time, const BlockNotUnit units, const BlockNotState state) {
+    baseUnits = units;
+    timerState = state;
+    if(timerState == STOPPED)
+        stop();
+    initDuration(time);
+    reset();
+    if (listing == BlockNotListing::listingListed) addToTimerList();
+}
+
 /**
  * Public Methods
  */
@@ -217,71 +520,47 @@ void BlockNot::setDuration(const unsigned long time, BlockNotUnit inUnits, const
 }
 
 void BlockNot::addTime(const unsigned long time, const bool resetOption) {
-    unsigned long newDuration;
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            newDuration = duration.micros + time;
-            if (newDuration < duration.micros) newDuration = 0xFFFFFFFFL;
-            duration.micros = newDuration;
-            break;
-        }
-        default: {
-            newDuration = duration.millis + time;
-            if (newDuration < duration.millis) newDuration = 0xFFFFFFFFL;
-            duration.millis = newDuration;
-            break;
-        }
-    }
+    const unsigned long newDuration = (time > 0xFFFFFFFFUL - rawDuration) ? 0xFFFFFFFFUL : rawDuration + time;
+    setTicks(duration, newDuration);
+    updateRawDuration();
     if (resetOption) reset();
 }
 
 void BlockNot::takeTime(const unsigned long time, const bool resetOption) {
-    long newDuration;
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            newDuration = duration.micros - time;
-            if (newDuration > duration.micros) newDuration = 0L;
-            duration.micros = newDuration;
-            break;
-        }
-        default: {
-            newDuration = duration.millis - time;
-            if (newDuration > duration.millis) newDuration = 0L;
-            duration.millis = newDuration;
-            break;
-        }
-    }
+    const unsigned long newDuration = (time > rawDuration) ? 0 : rawDuration - time;
+    setTicks(duration, newDuration);
+    updateRawDuration();
     if (resetOption) reset();
 }
 
 bool BlockNot::triggered(const bool resetOption) {
+    if (resetOption && overrunPolicy != OVERRUN_DEFAULT)
+        return timerState == RUNNING && triggeredWithPolicy();
     const bool triggered = hasTriggered();
     if (resetOption && triggered) {
-        reset();
+        const unsigned long periods = periodsSinceReset();
+        overrunCount += (periods > 1) ? periods - 1 : 0;
+        traceEvent(TRACE_TRIGGER);
+        restartTimer(0);
     }
     return timerState == RUNNING && triggered;
 }
 
 bool BlockNot::triggeredOnDuration(const bool allMissed) {
+    if (overrunPolicy != OVERRUN_DEFAULT)
+        return timerState == RUNNING && triggeredWithPolicy();
     const bool triggered = hasTriggered();
     if (triggered) {
-        unsigned long missedDurations;
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                missedDurations = timeSinceReset() / static_cast<unsigned long>(duration.micros);
-                break;
-            }
-            default: {
-                missedDurations = timeSinceReset() / static_cast<unsigned long>(duration.millis);
-                break;
-            }
-        }
+        const unsigned long missedDurations = periodsSinceReset();
+        overrunCount += (missedDurations > 1) ? missedDurations - 1 : 0;
         totalMissedDurations += (allMissed ? missedDurations : 0);
         const unsigned long newStartTime = getDurationTriggerStartTime();
-        reset(newStartTime);
+        traceEvent(TRACE_TRIGGER);
+        restartTimer(newStartTime);
     }
     if (totalMissedDurations > 0 && allMissed) {
         totalMissedDurations--;
+        traceEvent(TRACE_TRIGGER);
         return true;
     }
     return triggered;
@@ -310,23 +589,47 @@ void BlockNot::setFirstTriggerResponse(const bool response) {
     firstTriggerResponse = response;
 }
 
+void BlockNot::setOverrunPolicy(const BlockNotOverrun policy, const unsigned long burstLimit) {
+    overrunPolicy = policy;
+    overrunLimit = burstLimit;
+    totalMissedDurations = 0;
+}
+
+BlockNotOverrun BlockNot::getOverrunPolicy() const {
+    return overrunPolicy;
+}
+
+unsigned long BlockNot::getOverrunCount() const {
+    return overrunCount;
+}
+
+void BlockNot::clearOverrunCount() {
+    overrunCount = 0;
+}
+
+unsigned long BlockNot::getPendingCatchUps() const {
+    return totalMissedDurations > 0 ? totalMissedDurations : 0;
+}
+
+BlockNotAwait BlockNot::after(const unsigned long time) {
+    setDuration(time, WITH_RESET);
+    BlockNotAwait await = {this};
+    return await;
+}
+
+BlockNotAwait BlockNot::next() {
+    BlockNotAwait await = {this};
+    return await;
+}
+
 unsigned long BlockNot::getNextTriggerTime() const {
     cTime nextTrigger;
     if (triggerOnNext) {
-        nextTrigger.micros = micros();
-        nextTrigger.millis = millis();
+        nextTrigger.micros = clockMicros();
+        nextTrigger.millis = clockMillis();
     }
     else {
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                nextTrigger.micros = startTime + duration.micros;
-                break;
-            }
-            default: {
-                nextTrigger.millis = startTime + duration.millis;
-                break;
-            }
-        }
+        setTicks(nextTrigger, static_cast<uint32_t>(startTime + rawDuration));
     }
     return convertUnits(nextTrigger);
 }
@@ -337,16 +640,7 @@ unsigned long BlockNot::getTimeUntilTrigger() const {
 
 unsigned long BlockNot::getStartTime() const {
     cTime sTime;
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            sTime.micros = startTime;
-            break;
-        }
-        default: {
-            sTime.millis = startTime;
-            break;
-        }
-    }
+    setTicks(sTime, startTime);
     return convertUnits(sTime);
 }
 
@@ -357,11 +651,13 @@ unsigned long BlockNot::getStartTime(const BlockNotUnit units) const {
         case MINUTES:
             return timeValue.minutes;
         case SECONDS:
-            return timeValue.seconds;
+            return timeValue.getSeconds();
         case MILLISECONDS:
             return timeValue.millis;
         case MICROSECONDS:
             return timeValue.micros;
+        case CYCLES:
+            return timeValue.cycles;
     }
     return 0L;
 }
@@ -375,21 +671,12 @@ unsigned long BlockNot::lastTriggerDuration() const {
 }
 
 String BlockNot::getUnits() const {
-    return (baseUnits == SECONDS) ? "Seconds" : (baseUnits == MILLISECONDS) ?  "Milliseconds" : "Microseconds";
+    return (baseUnits == SECONDS) ? "Seconds" : (baseUnits == MILLISECONDS) ?  "Milliseconds" : (baseUnits == CYCLES) ? "Cycles" : "Microseconds";
 }
 
 unsigned long BlockNot::getTimeSinceLastReset() const {
     cTime timeLapsed;
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            timeLapsed.micros = timeSinceReset();
-            break;
-        }
-        default: {
-            timeLapsed.millis = timeSinceReset();
-            break;
-        }
-    }
+    setTicks(timeLapsed, timeSinceReset());
     return (timerState == RUNNING) ? convertUnits(timeLapsed) : timerStoppedReturnValue;
 }
 
@@ -399,34 +686,18 @@ void BlockNot::setStoppedReturnValue(const unsigned long stoppedReturnValue) {
 
 void BlockNot::start(const bool resetOption) {
     if(resetOption)
-        reset();
+        restartTimer(0);
     else {
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                startTime = micros() - stopTime.micros;
-                break;
-            }
-            default: {
-                startTime = millis() - stopTime.millis;
-                break;
-            }
-        }
+        startTime = clockTicks() - static_cast<unsigned long>(ticksOf(stopTime));
     }
     timerState = RUNNING;
+    traceEvent(TRACE_START);
 }
 
 void BlockNot::stop() {
     timerState = STOPPED;
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            stopTime.micros = micros();
-            break;
-        }
-        default: {
-            stopTime.millis = millis();
-            break;
-        }
-    }
+    traceEvent(TRACE_STOP);
+    setTicks(stopTime, clockTicks());
 }
 
 bool BlockNot::isRunning() const {return timerState == RUNNING;}
@@ -449,7 +720,7 @@ unsigned long BlockNot::convert(const unsigned long value, const BlockNotUnit un
             break;
         }
         case SECONDS: {
-            timeValue.seconds = value;
+            timeValue.setSeconds(value);
             break;
         }
         case MILLISECONDS: {
@@ -460,6 +731,10 @@ unsigned long BlockNot::convert(const unsigned long value, const BlockNotUnit un
             timeValue.micros = value;
             break;
         }
+        case CYCLES: {
+            timeValue.cycles = value;
+            break;
+        }
     }
     switch(units) {
         case MINUTES: {
@@ -467,7 +742,7 @@ unsigned long BlockNot::convert(const unsigned long value, const BlockNotUnit un
             break;
         }
         case SECONDS: {
-            result = timeValue.seconds;
+            result = timeValue.getSeconds();
             break;
         }
         case MILLISECONDS: {
@@ -478,29 +753,22 @@ unsigned long BlockNot::convert(const unsigned long value, const BlockNotUnit un
             result = timeValue.micros;
             break;
         }
+        case CYCLES: {
+            result = timeValue.cycles;
+            break;
+        }
     }
     return result;
 }
 
-void BlockNot::switchTo(const BlockNotUnit units) { baseUnits = units; }
+void BlockNot::switchTo(const BlockNotUnit units) {
+    baseUnits = units;
+    updateRawDuration();
+}
 
 void BlockNot::reset(const unsigned long newStartTime) {
-    unsigned long finalStartTime = newStartTime;
-    if(finalStartTime == 0) {
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                finalStartTime = micros() + microsOffset;
-                break;
-            }
-            default: {
-                finalStartTime = millis() + millisOffset;
-                if (speedCompensation)
-                    delay(compTime);
-                break;
-            }
-        }
-    }
-    resetTimer(finalStartTime);
+    traceEvent(TRACE_RESET);
+    restartTimer(newStartTime);
 }
 
 void BlockNot::setMillisOffset(const unsigned long offset) {
@@ -523,13 +791,320 @@ void BlockNot::disableSpeedComp() {
 }
 
 unsigned long BlockNot::getMillis() const {
-    return millis() + millisOffset;
+    return clockMillis() + millisOffset;
 }
 
 BlockNotUnit BlockNot::getBaseUnits() const {
     return baseUnits;
 }
 
+size_t BlockNot::snapshot(uint8_t *buffer, const size_t size) const {
+    if (buffer == nullptr || size < BLOCKNOT_SNAPSHOT_SIZE(1)) return 0;
+    putHeader(buffer, 1);
+    writeRecord(buffer + BLOCKNOT_SNAPSHOT_HEADER_SIZE);
+    return BLOCKNOT_SNAPSHOT_SIZE(1);
+}
+
+bool BlockNot::restore(const uint8_t *buffer, const size_t size, const unsigned long sleptMillis) {
+    if (!validHeader(buffer, size) || buffer[3] != 1) return false;
+    if (!validRecord(buffer + BLOCKNOT_SNAPSHOT_HEADER_SIZE)) return false;
+    readRecord(buffer + BLOCKNOT_SNAPSHOT_HEADER_SIZE, sleptMillis);
+    return true;
+}
+
+size_t BlockNot::snapshotAll(uint8_t *buffer, const size_t size) {
+    const uint8_t count = getTimerCount();
+    if (buffer == nullptr || size < BLOCKNOT_SNAPSHOT_SIZE(count)) return 0;
+    putHeader(buffer, count);
+    uint8_t *record = buffer + BLOCKNOT_SNAPSHOT_HEADER_SIZE;
+    const uint8_t *end = buffer + BLOCKNOT_SNAPSHOT_SIZE(count);
+    forEachTimer([&record, end](const BlockNot &timer) {
+        if (record >= end) return;
+        timer.writeRecord(record);
+        record += BLOCKNOT_SNAPSHOT_RECORD_SIZE;
+    });
+    return BLOCKNOT_SNAPSHOT_SIZE(count);
+}
+
+bool BlockNot::restoreAll(const uint8_t *buffer, const size_t size, const unsigned long sleptMillis) {
+    if (!validHeader(buffer, size) || buffer[3] != getTimerCount()) return false;
+    const uint8_t *record = buffer + BLOCKNOT_SNAPSHOT_HEADER_SIZE;
+    const uint8_t *end = buffer + BLOCKNOT_SNAPSHOT_SIZE(buffer[3]);
+    // Check every record before touching any timer, so a bad snapshot leaves them all alone
+    for (const uint8_t *check = record; check < end; check += BLOCKNOT_SNAPSHOT_RECORD_SIZE) {
+        if (!validRecord(check)) return false;
+    }
+    forEachTimer([&record, end, sleptMillis](BlockNot &timer) {
+        if (record >= end) return;
+        timer.readRecord(record, sleptMillis);
+        record += BLOCKNOT_SNAPSHOT_RECORD_SIZE;
+    });
+    return true;
+}
+
+uint8_t BlockNot::getTimerCount() {
+    uint8_t count = 0;
+    forEachTimer([&count](const BlockNot &) {
+        if (count < 0xFF) count++;
+    });
+    return count;
+}
+
+void BlockNot::setClock(const BlockNotClock millisSource, const BlockNotClock microsSource) {
+    // A new clock source starts the corrected clock over from wherever the new source reads
+    correctionActive = false;
+    millisClock = millisSource;
+    microsClock = microsSource;
+    anchorClock(millisCorrection, getRawMillis(), 0);
+    anchorClock(microsCorrection, getRawMicros(), 0);
+    correctionActive = clockAdjust != 0;
+}
+
+void BlockNot::setClockCorrection(const long ppb) {
+    /*
+     * Both clocks are anchored where they read now at the old rate, so the change has no jump
+     * in it. Going back to zero switches the correction off, unless the clocks have already
+     * drifted away from the raw ones - they then stay that far apart, which costs an addition.
+     */
+    const bool millisDrifted = anchorClock(millisCorrection, getRawMillis(), clockAdjust);
+    const bool microsDrifted = anchorClock(microsCorrection, getRawMicros(), clockAdjust);
+    {
+        BlockNotCritical critical;
+        clockPpb = ppb;
+        clockAdjust = static_cast<int32_t>((static_cast<int64_t>(ppb) << 32) / 1000000000LL);
+    }
+    correctionActive = ppb != 0 || millisDrifted || microsDrifted;
+}
+
+long BlockNot::getClockCorrection() {
+    return clockPpb;
+}
+
+unsigned long BlockNot::getRawMillis() {
+    return millisClock == nullptr ? millis() : millisClock();
+}
+
+unsigned long BlockNot::getRawMicros() {
+    return microsClock == nullptr ? micros() : microsClock();
+}
+
+bool BlockNot::removeFromTimerList() {
+    // The linker puts BLOCKNOT_STATIC() timers in the table, and nothing can take them out again
+    for (BlockNot *const *entry = tableBegin(); entry != tableEnd(); entry++) {
+        if (*entry == this) return false;
+    }
+#ifndef BLOCKNOT_NO_TIMER_LIST
+    BlockNot *previous = nullptr;
+    for (BlockNot *current = firstTimer; current != nullptr; previous = current, current = current->nextTimer) {
+        if (current != this) continue;
+        if (previous == nullptr)
+            firstTimer = nextTimer;
+        else
+            previous->nextTimer = nextTimer;
+        if (currentTimer == this) currentTimer = previous;
+        nextTimer = nullptr;
+        break;
+    }
+#endif
+    return true;
+}
+
+uint8_t BlockNot::getTableCount() {
+    const size_t count = tableEnd() - tableBegin();
+    return count < 0xFF ? count : 0xFF;
+}
+
+unsigned long BlockNot::getRawTimeUntilTrigger() const {
+    return (timerState == RUNNING) ? remaining() : 0L;
+}
+
+unsigned long BlockNot::getRawElapsed() const {
+    return (timerState == RUNNING) ? timeSinceReset() : timerStoppedReturnValue;
+}
+
+unsigned long BlockNot::getRawDuration() const {
+    return rawDuration;
+}
+
+BlockNotStatus BlockNot::status() const {
+    BlockNotStatus result;
+    result.duration = rawDuration;
+    result.missed = getPendingCatchUps();
+    result.overruns = overrunCount;
+    result.running = timerState == RUNNING;
+    if (result.running) {
+        result.elapsed = static_cast<uint32_t>(nowTicks() - startTime);
+        result.due = triggerOnNext || result.elapsed >= rawDuration;
+        result.remaining = result.due ? 0 : rawDuration - result.elapsed;
+    }
+    else {
+        result.elapsed = timerStoppedReturnValue;
+        result.remaining = timerStoppedReturnValue;
+        result.due = false;
+    }
+    return result;
+}
+
+BlockNotDeadline BlockNot::deadline() const {
+    BlockNotDeadline result;
+    result.status = status();
+    result.units = getTickUnits(baseUnits);
+    result.slack = slackTicks;
+    return result;
+}
+
+bool BlockNot::addWakeupSource(const BlockNotWakeupSource source, const void *owner) {
+    /*
+     * Pools, timeout sets and PWM keep their timers out of the list, so they add
+     * themselves here when they are built and come back out when they are destroyed.
+     * The table is plain static storage, so it is ready before any global constructor runs.
+     */
+    if (source == nullptr || wakeupSourceCount >= BLOCKNOT_WAKEUP_SOURCES) return false;
+    wakeupSources[wakeupSourceCount] = source;
+    wakeupOwners[wakeupSourceCount++] = owner;
+    return true;
+}
+
+bool BlockNot::removeWakeupSource(const void *owner) {
+    for (uint8_t i = 0; i < wakeupSourceCount; i++) {
+        if (wakeupOwners[i] != owner) continue;
+        wakeupSourceCount--;
+        wakeupSources[i] = wakeupSources[wakeupSourceCount];
+        wakeupOwners[i] = wakeupOwners[wakeupSourceCount];
+        return true;
+    }
+    return false;
+}
+
+unsigned long BlockNot::getMicrosUntilNextTrigger() {
+    return nextTriggerMicros(false);
+}
+
+unsigned long BlockNot::getMicrosUntilNextWakeup() {
+    return nextTriggerMicros(coalescing);
+}
+
+BlockNotUnit BlockNot::getTickUnits(const BlockNotUnit units) {
+    // SECONDS and MINUTES timers tick in milliseconds
+    return (units == MICROSECONDS || units == CYCLES) ? units : MILLISECONDS;
+}
+
+uint64_t BlockNot::ticksToMicros(const unsigned long ticks, const BlockNotUnit units) {
+    // Rounded up, so waiting this long never wakes up before the ticks have gone by
+    switch(getTickUnits(units)) {
+        case MICROSECONDS:
+            return ticks;
+        case CYCLES:
+            return (static_cast<uint64_t>(ticks) * 1000000ULL + getCycleFrequency() - 1) / getCycleFrequency();
+        default:
+            return static_cast<uint64_t>(ticks) * 1000ULL;
+    }
+}
+
+void BlockNot::setSlack(const unsigned long time) {
+    cTime slack;
+    switch(baseUnits) {
+        case MINUTES: {
+            slack.minutes = time;
+            break;
+        }
+        case SECONDS: {
+            slack.setSeconds(time);
+            break;
+        }
+        case MILLISECONDS: {
+            slack.millis = time;
+            break;
+        }
+        case MICROSECONDS: {
+            slack.micros = time;
+            break;
+        }
+        case CYCLES: {
+            slack.cycles = time;
+            break;
+        }
+    }
+    slackTicks = static_cast<unsigned long>(ticksOf(slack));
+}
+
+unsigned long BlockNot::getSlack() const {
+    cTime slack;
+    setTicks(slack, slackTicks);
+    return convertUnits(slack);
+}
+
+unsigned long BlockNot::getRawSlack() const {
+    return slackTicks;
+}
+
+void BlockNot::setCoalescing(const bool enabled) {
+    coalescing = enabled;
+}
+
+bool BlockNot::isCoalescing() {
+    return coalescing;
+}
+
+void BlockNot::setTraceHook(const BlockNotTraceHook hook) {
+    traceHook = hook;
+}
+
+unsigned long BlockNot::getCycles() {
+    return clockCycles();
+}
+
+void BlockNot::setCycleFrequency(const unsigned long hz) {
+    // Cycles already counted from micros() stay counted at the old frequency
+    if (cycleFrequency != 0) anchorCycles(clockMicros(), cycleFrequency);
+    cycleFrequency = hz;
+}
+
+unsigned long BlockNot::getCycleFrequency() {
+    /*
+     * F_CPU when the core defines it, otherwise the counter is measured against micros()
+     * the first time it is needed. That is only when cycles are converted to or from other
+     * units - building and checking a CYCLES timer never needs it - and calling
+     * calibrateCycleFrequency() from setup() picks when the wait happens instead. Without a
+     * cycle counter, cycles are counted from micros() and one cycle per microsecond is as
+     * good as any.
+     */
+    if (cycleFrequency == 0) {
+        cycleFrequency = BLOCKNOT_CYCLE_FREQUENCY;
+        if (cycleFrequency == 0) {
+            cycleFrequency = 1000000UL;
+#ifdef BLOCKNOT_CYCLE_COUNTER
+            calibrateCycleFrequency();
+#endif
+        }
+    }
+    return cycleFrequency;
+}
+
+unsigned long BlockNot::calibrateCycleFrequency(const unsigned long windowMicros) {
+#ifdef BLOCKNOT_CYCLE_COUNTER
+    // A replaced clock (like the simulator) does not move while we wait, and cycles follow it anyway
+    if (microsClock == nullptr && windowMicros > 0) {
+        // Give up if micros() isn't running yet, like in a constructor before the core has started
+        const unsigned long startMicros = clockMicros();
+        uint32_t tries = 0;
+        while (clockMicros() == startMicros) {
+            if (++tries == 1000000UL) return getCycleFrequency();
+        }
+        const unsigned long firstMicros = clockMicros();
+        const uint32_t firstCycles = readCycleCounter();
+        unsigned long elapsed;
+        do {
+            elapsed = static_cast<uint32_t>(clockMicros() - firstMicros);
+        } while (elapsed < windowMicros);
+        const uint32_t cycles = readCycleCounter() - firstCycles;
+        setCycleFrequency(static_cast<unsigned long>(static_cast<uint64_t>(cycles) * 1000000ULL / elapsed));
+        return cycleFrequency;
+    }
+#endif
+    return getCycleFrequency();
+}
+
 void BlockNot::getHelp(Print &output, const bool haltCode) {
     output.println("\n\nThe following macros can be used for coding simplicity and to produce more readable code:\n");
     output.println("Macro\t\t\t\tMethod Called");
@@ -555,6 +1130,7 @@ void BlockNot::getHelp(Print &output, const bool haltCode) {
     output.println("ISRUNNING\t\t\tisRunning()");
     output.println("ISSTOPPED\t\t\tisStopped()");
     output.println("TOGGLE\t\t\t\ttoggle()");
+    output.println("STATUS\t\t\t\tstatus()");
     output.println("\nYou use macros like you would a method call only no neeed for passing arguments unless the macro");
     output.println("explicitely supports it:\n");
     output.println("if (myTimer.TRIGGERED) {");
@@ -575,6 +1151,23 @@ void BlockNot::getHelp(const bool haltCode) {
  * Private Methods
  */
 
+unsigned long BlockNot::clockMillis() {
+    const unsigned long raw = getRawMillis();
+    return correctionActive ? correctedClock(millisCorrection, raw, clockAdjust) : raw;
+}
+
+unsigned long BlockNot::clockMicros() {
+    const unsigned long raw = getRawMicros();
+    return correctionActive ? correctedClock(microsCorrection, raw, clockAdjust) : raw;
+}
+
+unsigned long BlockNot::clockCycles() {
+#ifdef BLOCKNOT_CYCLE_COUNTER
+    if (microsClock == nullptr) return readCycleCounter();
+#endif
+    return cyclesFromMicros(clockMicros(), getCycleFrequency());
+}
+
 void BlockNot::initDuration(const unsigned long time) {
     switch(baseUnits) {
         case MINUTES: {
@@ -582,7 +1175,7 @@ void BlockNot::initDuration(const unsigned long time) {
             break;
         }
         case SECONDS: {
-            duration.seconds = time;
+            duration.setSeconds(time);
             break;
         }
         case MILLISECONDS: {
@@ -593,7 +1186,12 @@ void BlockNot::initDuration(const unsigned long time) {
             duration.micros = time;
             break;
         }
+        case CYCLES: {
+            duration.cycles = time;
+            break;
+        }
     }
+    updateRawDuration();
 }
 
 void BlockNot::initDuration(const unsigned long time, const BlockNotUnit inUnits) {
@@ -605,13 +1203,18 @@ void BlockNot::initDuration(const unsigned long time, const BlockNotUnit inUnits
             duration.millis = time;
             break;
         case SECONDS:
-            duration.seconds = time;
+            duration.setSeconds(time);
             break;
         case MINUTES: {
             duration.minutes = time;
             break;
         }
+        case CYCLES: {
+            duration.cycles = time;
+            break;
+        }
     }
+    updateRawDuration();
 }
 
 void BlockNot::resetTimer(const unsigned long newStartTime) {
@@ -620,20 +1223,147 @@ void BlockNot::resetTimer(const unsigned long newStartTime) {
     onceTriggered = false;
 }
 
+void BlockNot::restartTimer(const unsigned long newStartTime) {
+    // reset() without the trace event, for the places that already traced a trigger
+    unsigned long finalStartTime = newStartTime;
+    if(finalStartTime == 0) {
+        switch(baseUnits) {
+            case MICROSECONDS: {
+                finalStartTime = clockMicros() + microsOffset;
+                break;
+            }
+            case CYCLES: {
+                finalStartTime = clockCycles();
+                break;
+            }
+            default: {
+                finalStartTime = clockMillis() + millisOffset;
+                if (speedCompensation)
+                    delay(compTime);
+                break;
+            }
+        }
+    }
+    resetTimer(finalStartTime);
+}
+
+void BlockNot::traceEvent(const BlockNotEvent event) const {
+    if (traceHook == nullptr) return;
+    unsigned long lateness = 0;
+    if (event == TRACE_TRIGGER) {
+        const unsigned long sinceReset = timeSinceReset();
+        lateness = (sinceReset > rawDuration) ? sinceReset - rawDuration : 0;
+    }
+    traceHook(*this, event, lateness);
+}
+
 unsigned long BlockNot::timeSinceReset() const {
-    unsigned long result;
-    unsigned long millisBase = millisOffset + millis();
+    /*
+     * millis() and micros() roll over at 32 bits on every Arduino core, so the difference
+     * is kept in 32 bits as well - otherwise a 64 bit host would see a rollover as a huge
+     * elapsed time. The cycle counters are 32 bits wide as well.
+     */
+    return static_cast<uint32_t>(nowTicks() - startTime);
+}
+
+unsigned long BlockNot::nowTicks() const {
+    return clockTicks() + tickOffset();
+}
+
+unsigned long BlockNot::clockTicks() const {
+    return (baseUnits == MICROSECONDS) ? clockMicros() : (baseUnits == CYCLES) ? clockCycles() : clockMillis();
+}
+
+unsigned long BlockNot::tickOffset() const {
+    // Offsets only apply to micros() and millis()
+    return (baseUnits == MICROSECONDS) ? microsOffset : (baseUnits == CYCLES) ? 0 : millisOffset;
+}
+
+double BlockNot::ticksOf(const cTime &timeValue) const {
+    return (baseUnits == MICROSECONDS) ? timeValue.micros : (baseUnits == CYCLES) ? timeValue.cycles : timeValue.millis;
+}
+
+void BlockNot::setTicks(cTime &timeValue, const double ticks) const {
     switch(baseUnits) {
         case MICROSECONDS: {
-            result = microsOffset + micros() - startTime;
+            timeValue.micros = ticks;
+            break;
+        }
+        case CYCLES: {
+            timeValue.cycles = ticks;
             break;
         }
         default: {
-            result = millisBase - startTime;
+            timeValue.millis = ticks;
             break;
         }
     }
-    return result;
+}
+
+void BlockNot::updateRawDuration() {
+    // Rounded, since going through seconds can leave a duration a hair under a whole tick
+    const double ticks = ticksOf(duration);
+    rawDuration = static_cast<unsigned long>(ticks + 0.5);
+}
+
+unsigned long BlockNot::periodsSinceReset() const {
+    // Whole durations since the last reset - anything past the first one is an overrun
+    return (rawDuration == 0) ? 0 : timeSinceReset() / rawDuration;
+}
+
+bool BlockNot::triggeredWithPolicy() {
+    /*
+     * Every period that went by without being checked counts as an overrun. What happens
+     * to those missed periods depends on the policy:
+     *
+     *  SKIP       - move to the most recent period mark, missed periods are dropped
+     *  BURST      - queue them (up to the limit) and hand them out on the following checks
+     *  SPREAD     - queue them and hand them out evenly spaced across the next period
+     *  COUNT_ONLY - reset to now like TRIGGERED, missed periods are only counted
+     */
+    if (hasTriggered()) {
+        const unsigned long periods = periodsSinceReset();
+        const unsigned long missed = (periods > 1) ? periods - 1 : 0;
+        overrunCount += missed;
+        traceEvent(TRACE_TRIGGER);
+        if (periods == 0 || overrunPolicy == OVERRUN_COUNT_ONLY) {
+            restartTimer(0);
+            return true;
+        }
+        unsigned long pending = getPendingCatchUps();
+        switch(overrunPolicy) {
+            case OVERRUN_BURST: {
+                pending += missed;
+                if (overrunLimit != NO_LIMIT && pending > overrunLimit) pending = overrunLimit;
+                break;
+            }
+            case OVERRUN_SPREAD: {
+                pending += missed;
+                catchUpInterval = rawDuration / (pending + 1);
+                lastCatchUp = nowTicks();
+                break;
+            }
+            default:
+                break;
+        }
+        totalMissedDurations = (pending > 0x7FFF) ? 0x7FFF : static_cast<int>(pending);
+        restartTimer(getDurationTriggerStartTime());
+        return true;
+    }
+    if (totalMissedDurations > 0) {
+        if (overrunPolicy == OVERRUN_BURST) {
+            totalMissedDurations--;
+            traceEvent(TRACE_TRIGGER);
+            return true;
+        }
+        if (overrunPolicy == OVERRUN_SPREAD && static_cast<uint32_t>(nowTicks() - lastCatchUp) >= catchUpInterval) {
+            totalMissedDurations--;
+            lastCatchUp = nowTicks();
+            traceEvent(TRACE_TRIGGER);
+            return true;
+        }
+    }
+    return false;
 }
 
 bool BlockNot::hasTriggered() {
@@ -641,34 +1371,20 @@ bool BlockNot::hasTriggered() {
         triggerOnNext = false;
         return true;
     }
-    bool triggered;
+    /*
+     * rawDuration is kept up to date by everything that changes the duration, so the poll is
+     * one subtraction and one compare. Measuring from startTime rather than comparing against
+     * an absolute deadline keeps the whole 32 bit range for the duration across rollover.
+     */
     const unsigned long sinceReset = timeSinceReset();
-    switch(baseUnits) {
-        case MICROSECONDS: {
-            triggered = sinceReset >= static_cast<unsigned long>(duration.micros);
-            break;
-        }
-        default: {
-            triggered = sinceReset >= static_cast<unsigned long>(duration.millis);
-            break;
-        }
-    }
+    const bool triggered = sinceReset >= rawDuration;
     if(triggered)
         lastDuration = sinceReset;
     return triggered;
 }
 
 bool BlockNot::hasNotTriggered() const {
-    bool notTriggered;
-    switch(baseUnits) {
-        case MICROSECONDS:
-            notTriggered = timeSinceReset() < static_cast<unsigned long>(duration.micros);
-            break;
-        default:
-            notTriggered = timeSinceReset() < static_cast<unsigned long>(duration.millis);
-            break;
-    }
-    return notTriggered;
+    return timeSinceReset() < rawDuration;
 }
 
 unsigned long BlockNot::timeTillTrigger() const {
@@ -676,18 +1392,8 @@ unsigned long BlockNot::timeTillTrigger() const {
     unsigned long tillTrigger = 0L;
     if (!triggerOnNext) {
         cTime triggerTime;
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                triggerTime.micros = (sinceReset < duration.micros) ? static_cast<unsigned long>(duration.micros - sinceReset) : 0L;
-                tillTrigger = (timerState == RUNNING) ? convertUnits(triggerTime) : timerStoppedReturnValue;
-                break;
-            }
-            default: {
-                triggerTime.millis = (sinceReset < duration.millis) ? static_cast<unsigned long>(duration.millis - sinceReset) : 0L;
-                tillTrigger = (timerState == RUNNING) ? convertUnits(triggerTime) : timerStoppedReturnValue;
-                break;
-            }
-        }
+        setTicks(triggerTime, (sinceReset < rawDuration) ? rawDuration - sinceReset : 0L);
+        tillTrigger = (timerState == RUNNING) ? convertUnits(triggerTime) : timerStoppedReturnValue;
     }
     return tillTrigger;
 }
@@ -695,44 +1401,133 @@ unsigned long BlockNot::timeTillTrigger() const {
 unsigned long BlockNot::remaining() const {
     const unsigned long timePassed = timeSinceReset();
     unsigned long remain = 0L;
-    if (!triggerOnNext) {
-        switch(baseUnits) {
-            case MICROSECONDS: {
-                remain = (timePassed < duration.micros) ? (static_cast<unsigned long>(duration.micros) - timePassed) : 0;
-                break;
-            }
-            default: {
-                remain = (timePassed < duration.millis) ? (static_cast<unsigned long>(duration.millis) - timePassed) : 0;
-                break;
-            }
-        }
-    }
+    if (!triggerOnNext)
+        remain = (timePassed < rawDuration) ? rawDuration - timePassed : 0;
     return remain;
 }
 
+unsigned long BlockNot::nextTriggerMicros(const bool withSlack) {
+    /*
+     * With slack, each timer is allowed to wait until the end of its own slack window,
+     * so the wakeup goes at the earliest end of any window. Every timer whose trigger
+     * falls before that point is then handled in the same wakeup.
+     */
+    unsigned long next = 0xFFFFFFFFUL;
+    forEachDeadline([&next, withSlack](const BlockNotDeadline &deadline) {
+        if (!deadline.status.running) return;
+        unsigned long tillTrigger = deadline.status.remaining;
+        if (withSlack)
+            tillTrigger = (tillTrigger > 0xFFFFFFFFUL - deadline.slack) ? 0xFFFFFFFFUL : tillTrigger + deadline.slack;
+        const uint64_t wait = ticksToMicros(tillTrigger, deadline.units);
+        if (wait < next) next = static_cast<unsigned long>(wait);
+    });
+    return next;
+}
+
 unsigned long BlockNot::getDurationTriggerStartTime() const {
-    unsigned long durationStartTime;
+    if (rawDuration == 0) return nowTicks();
+    return startTime + ((timeSinceReset() / rawDuration) * rawDuration);
+}
+
+unsigned long BlockNot::convertUnits(const cTime &timeValue) const {
+    return baseUnits == MINUTES ? timeValue.minutes :
+           baseUnits == SECONDS ? timeValue.getSeconds() :
+           baseUnits == MILLISECONDS ? timeValue.millis :
+           baseUnits == CYCLES ? timeValue.cycles :
+           timeValue.micros;
+}
+
+void BlockNot::writeRecord(uint8_t *record) const {
+    const unsigned long elapsed = timerState == RUNNING ? timeSinceReset() : static_cast<uint32_t>(static_cast<unsigned long>(ticksOf(stopTime)) + tickOffset() - startTime);
+    uint8_t flags = 0;
+    if (timerState == RUNNING) flags |= FLAG_RUNNING;
+    if (onceTriggered) flags |= FLAG_ONCE_TRIGGERED;
+    if (triggerOnNext) flags |= FLAG_TRIGGER_NEXT;
+    if (firstTriggerResponse) flags |= FLAG_FIRST_RESPONSE;
+    if (speedCompensation) flags |= FLAG_SPEED_COMP;
+    if (duration.isCycles()) flags |= FLAG_IN_CYCLES;
+    record[0] = flags;
+    record[1] = static_cast<uint8_t>(baseUnits);
+    putLong(record + 2, duration.isCycles() ? static_cast<unsigned long>(duration.cycles + 0.5) : rawDuration);
+    putLong(record + 6, elapsed);
+    putLong(record + 10, totalMissedDurations > 0 ? totalMissedDurations : 0);
+    putLong(record + 14, timerStoppedReturnValue);
+    putLong(record + 18, lastDuration);
+    putLong(record + 22, compTime);
+    record[26] = static_cast<uint8_t>(overrunPolicy);
+    putLong(record + 27, overrunLimit);
+    putLong(record + 31, overrunCount);
+    putLong(record + 35, catchUpInterval);
+    putLong(record + 39, static_cast<uint32_t>(nowTicks() - lastCatchUp));
+    putLong(record + 43, slackTicks);
+}
+
+void BlockNot::readRecord(const uint8_t *record, const unsigned long sleptMillis) {
+    const uint8_t flags = record[0];
+    baseUnits = static_cast<BlockNotUnit>(record[1]);
+    timerState = (flags & FLAG_RUNNING) ? RUNNING : STOPPED;
+    onceTriggered = flags & FLAG_ONCE_TRIGGERED;
+    triggerOnNext = flags & FLAG_TRIGGER_NEXT;
+    firstTriggerResponse = flags & FLAG_FIRST_RESPONSE;
+    speedCompensation = flags & FLAG_SPEED_COMP;
+    unsigned long elapsed = getLong(record + 6);
+    totalMissedDurations = static_cast<int>(getLong(record + 10));
+    timerStoppedReturnValue = getLong(record + 14);
+    lastDuration = getLong(record + 18);
+    compTime = getLong(record + 22);
+    overrunPolicy = static_cast<BlockNotOverrun>(record[26]);
+    overrunLimit = getLong(record + 27);
+    overrunCount = getLong(record + 31);
+    catchUpInterval = getLong(record + 35);
+    slackTicks = getLong(record + 43);
+    /*
+     * A stopped timer does not pass time while the MCU sleeps, so only running timers
+     * are rebased by the slept time. The sum is clamped so that a very long sleep reads
+     * as "overdue" instead of wrapping back around to a small elapsed value.
+     */
     switch(baseUnits) {
         case MICROSECONDS: {
-            durationStartTime = startTime + ((timeSinceReset() / static_cast<unsigned long>(duration.micros)) * static_cast<unsigned long>(duration.micros));
+            duration.micros = getLong(record + 2);
+            if (timerState == RUNNING) {
+                const unsigned long slept = (sleptMillis > 0xFFFFFFFFUL / 1000UL) ? 0xFFFFFFFFUL : sleptMillis * 1000UL;
+                elapsed = (elapsed > 0xFFFFFFFFUL - slept) ? 0xFFFFFFFFUL : elapsed + slept;
+            }
+            const unsigned long now = clockMicros();
+            startTime = now + microsOffset - elapsed;
+            stopTime.micros = now;
+            break;
+        }
+        case CYCLES: {
+            duration.cycles = getLong(record + 2);
+            if (timerState == RUNNING) {
+                const uint64_t slept = static_cast<uint64_t>(sleptMillis) * getCycleFrequency() / 1000ULL;
+                elapsed = (slept > 0xFFFFFFFFUL - elapsed) ? 0xFFFFFFFFUL : elapsed + static_cast<unsigned long>(slept);
+            }
+            const unsigned long now = clockCycles();
+            startTime = now - elapsed;
+            stopTime.cycles = now;
             break;
         }
         default: {
-            durationStartTime = startTime + ((timeSinceReset() / static_cast<unsigned long>(duration.millis)) * static_cast<unsigned long>(duration.millis));
+            duration.millis = getLong(record + 2);
+            if (timerState == RUNNING)
+                elapsed = (elapsed > 0xFFFFFFFFUL - sleptMillis) ? 0xFFFFFFFFUL : elapsed + sleptMillis;
+            const unsigned long now = clockMillis();
+            startTime = now + millisOffset - elapsed;
+            stopTime.millis = now;
             break;
         }
     }
-    return durationStartTime;
-}
-
-unsigned long BlockNot::convertUnits(const cTime &timeValue) const {
-    return baseUnits == MINUTES ? timeValue.minutes :
-           baseUnits == SECONDS ? timeValue.seconds :
-           baseUnits == MILLISECONDS ? timeValue.millis :
-           timeValue.micros;
+    // A duration set in cycles goes back in cycles, so it stays exact whatever the base units
+    if (flags & FLAG_IN_CYCLES)
+        duration.cycles = getLong(record + 2);
+    // The catch-up clock doesn't run while the MCU sleeps, so it picks up where it left off
+    lastCatchUp = static_cast<uint32_t>(nowTicks() - getLong(record + 39));
+    updateRawDuration();
 }
 
 void BlockNot::addToTimerList() {
+#ifndef BLOCKNOT_NO_TIMER_LIST
     if (firstTimer == nullptr) {
         firstTimer = currentTimer = this;
     } else {
@@ -740,6 +1535,23 @@ void BlockNot::addToTimerList() {
         currentTimer = this;
     }
     this->nextTimer = nullptr;
+#endif
+}
+
+BlockNot *const *BlockNot::tableBegin() {
+#ifdef BLOCKNOT_TIMER_SECTION
+    return __start_blocknot_timers;
+#else
+    return nullptr;
+#endif
+}
+
+BlockNot *const *BlockNot::tableEnd() {
+#ifdef BLOCKNOT_TIMER_SECTION
+    return __stop_blocknot_timers;
+#else
+    return nullptr;
+#endif
 }
 
 /**
@@ -747,9 +1559,7 @@ void BlockNot::addToTimerList() {
  */
 
 void resetAllTimers(const unsigned long newStartTime) {
-    BlockNot *current = BlockNot::firstTimer;
-    while (current != nullptr) {
-        current->reset(newStartTime);
-        current = current->nextTimer;
-    }
+    BlockNot::forEachTimer([newStartTime](BlockNot &timer) {
+        timer.reset(newStartTime);
+    });
 }
\ No newline at end of file
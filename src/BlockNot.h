@@ -23,7 +23,7 @@
  */
 
 enum BlockNotUnit {
-    mic_cTime, mil_cTime, sec_cTime, min_cTime
+    mic_cTime, mil_cTime, sec_cTime, min_cTime, cyc_cTime
 };
 enum BlockNotGlobal {
     yes, no
@@ -31,6 +31,121 @@ enum BlockNotGlobal {
 enum BlockNotState {
     running, stopped
 };
+enum BlockNotListing {
+    listingUnlisted, listingListed
+};
+
+enum BlockNotOverrun {
+    overrunLegacy, overrunSkip, overrunBurst, overrunSpread, overrunCountOnly
+};
+
+enum BlockNotEvent {
+    traceTrigger, traceReset, traceStart, traceStop
+};
+
+typedef unsigned long (*BlockNotClock)();
+
+class BlockNot;
+
+/**
+ * Runs the work for a timer that triggered - used by BlockNotShards and BlockNotDispatcher
+ */
+typedef void (*BlockNotHandler)(BlockNot &timer);
+
+/**
+ * Called on every trigger, reset, start and stop when set with setTraceHook() - lateness is
+ * how far past its duration a timer triggered, in raw ticks (see BlockNotTrace.h)
+ */
+typedef void (*BlockNotTraceHook)(const BlockNot &timer, BlockNotEvent event, unsigned long lateness);
+
+/**
+ * Everything about a timer from a single clock read, in raw ticks - micros() for
+ * MICROSECONDS timers, CPU cycles for CYCLES timers and millis() for all others
+ */
+struct BlockNotStatus {
+    unsigned long elapsed;
+    unsigned long remaining;
+    unsigned long duration;
+    unsigned long missed;
+    unsigned long overruns;
+    bool due;
+    bool running;
+};
+
+/**
+ * The next deadline of a timer, or of something that keeps its own timers out of the list
+ * (a pool, a timeout set, a PWM edge) - the status in raw ticks of the given units, which
+ * are always MILLISECONDS, MICROSECONDS or CYCLES
+ */
+struct BlockNotDeadline {
+    BlockNotStatus status;
+    BlockNotUnit units;
+    unsigned long slack;
+};
+
+typedef void (*BlockNotDeadlineVisit)(const BlockNotDeadline &deadline, void *context);
+
+/**
+ * Hands each of the owner's deadlines to visit, passing context along - registered with
+ * addWakeupSource() so the wakeup queries see timers that are not in the list
+ */
+typedef void (*BlockNotWakeupSource)(const void *owner, BlockNotDeadlineVisit visit, void *context);
+
+/**
+ * Wakeup sources - see Build Flags in README.md
+ */
+#ifndef BLOCKNOT_WAKEUP_SOURCES
+#define BLOCKNOT_WAKEUP_SOURCES     8
+#endif
+
+/**
+ * Returned by after() and next() - co_await it from a coroutine (see BlockNotCoroutine.h)
+ */
+struct BlockNotAwait {
+    BlockNot *timer;
+};
+
+/**
+ * Holds interrupts off for as long as it is in scope, for the few places that share state
+ * with interrupt handlers on boards without <atomic>. The interrupt state is saved and put
+ * back the way it was found instead of being switched on, so it is safe inside a handler or
+ * inside another critical section - on AVR, ESP32, ESP8266, Cortex-M (including RP2040),
+ * RP2350 and other bare metal RISC-V boards. Anywhere else the state can't be read, so
+ * leaving the scope always switches interrupts on, and it must not be used from a handler.
+ */
+class BlockNotCritical {
+public:
+#if defined(__AVR__)
+    BlockNotCritical() : state(SREG) { cli(); }
+    ~BlockNotCritical() { SREG = state; }
+private:
+    uint8_t state;
+#elif defined(ESP32)
+    BlockNotCritical() : state(portSET_INTERRUPT_MASK_FROM_ISR()) {}
+    ~BlockNotCritical() { portCLEAR_INTERRUPT_MASK_FROM_ISR(state); }
+private:
+    UBaseType_t state;
+#elif defined(ESP8266)
+    BlockNotCritical() : state(xt_rsil(15)) {}
+    ~BlockNotCritical() { xt_wsr_ps(state); }
+private:
+    uint32_t state;
+#elif defined(__arm__) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+    BlockNotCritical() { __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r"(state) :: "memory"); }
+    ~BlockNotCritical() { __asm__ volatile("msr primask, %0" :: "r"(state) : "memory"); }
+private:
+    uint32_t state;
+#elif defined(__riscv) && !defined(__linux__)
+    // Clears MIE in mstatus and keeps the old value of the bit
+    BlockNotCritical() { __asm__ volatile("csrrci %0, mstatus, 8" : "=r"(state) :: "memory"); }
+    ~BlockNotCritical() { __asm__ volatile("csrs mstatus, %0" :: "r"(state & 8) : "memory"); }
+private:
+    unsigned long state;
+#else
+    BlockNotCritical() { noInterrupts(); }
+    ~BlockNotCritical() { interrupts(); }
+#endif
+};
 
 #define WITH_RESET true
 #define NO_RESET   false
@@ -39,10 +154,47 @@ enum BlockNotState {
 #define MILLISECONDS            BlockNotUnit::mil_cTime
 #define SECONDS                 BlockNotUnit::sec_cTime
 #define MINUTES                 BlockNotUnit::min_cTime
+#define CYCLES                  BlockNotUnit::cyc_cTime
 #define NO_GLOBAL_RESET         BlockNotGlobal::no
 #define GLOBAL_RESET            BlockNotGlobal::yes
 #define RUNNING                 BlockNotState::running
 #define STOPPED                 BlockNotState::stopped
+#define OVERRUN_DEFAULT         BlockNotOverrun::overrunLegacy
+#define OVERRUN_SKIP            BlockNotOverrun::overrunSkip
+#define OVERRUN_BURST           BlockNotOverrun::overrunBurst
+#define OVERRUN_SPREAD          BlockNotOverrun::overrunSpread
+#define OVERRUN_COUNT_ONLY      BlockNotOverrun::overrunCountOnly
+#define NO_LIMIT                0
+#define TRACE_TRIGGER           BlockNotEvent::traceTrigger
+#define TRACE_RESET             BlockNotEvent::traceReset
+#define TRACE_START             BlockNotEvent::traceStart
+#define TRACE_STOP              BlockNotEvent::traceStop
+#define UNLISTED                BlockNotListing::listingUnlisted
+
+/**
+ * Timer table - timers declared with BLOCKNOT_STATIC() at file scope are collected into
+ * one array by the linker instead of being linked together when they are constructed.
+ * It is only turned on where the linker is known to keep the section and mark where it
+ * starts and ends - GNU ld on Linux, or any GCC ELF toolchain built with the
+ * BLOCKNOT_USE_TIMER_SECTION flag once you have checked that your linker script does.
+ * Embedded linker scripts (ESP-IDF ldgen, the RP2040 and STM32 cores) can drop the section
+ * without a word, so everywhere else, and with the BLOCKNOT_NO_TIMER_SECTION build flag,
+ * BLOCKNOT_STATIC() makes an ordinary timer in the global reset list.
+ * Both ways go through the listing constructors, so they take the same arguments -
+ * the duration, then optionally the units and the starting state.
+ * The BLOCKNOT_NO_TIMER_LIST build flag drops the global reset list, and the pointer it
+ * costs in every timer, so only the timers in the table are seen by RESET_TIMERS and friends.
+ */
+
+#if defined(__ELF__) && defined(__GNUC__) && !defined(__AVR__) && !defined(BLOCKNOT_NO_TIMER_SECTION) && \
+    (defined(__linux__) || defined(BLOCKNOT_USE_TIMER_SECTION))
+#define BLOCKNOT_TIMER_SECTION
+#define BLOCKNOT_STATIC(name, ...) \
+    BlockNot name(UNLISTED, __VA_ARGS__); \
+    BlockNot *const blockNotTable_##name __attribute__((section("blocknot_timers"), used, aligned(sizeof(BlockNot *)))) = &name
+#else
+#define BLOCKNOT_STATIC(name, ...) BlockNot name(BlockNotListing::listingListed, __VA_ARGS__)
+#endif
 
 #define ELAPSED                     getTimeSinceLastReset()
 #define REMAINING                   getTimeUntilTrigger()
@@ -109,6 +261,16 @@ enum BlockNotState {
 #define ISRUNNING                   isRunning()
 #define ISSTOPPED                   isStopped()
 #define TOGGLE                      toggle()
+#define STATUS                      status()
+
+/**
+ * Snapshot format - see the Deep Sleep section in README.md
+ */
+
+#define BLOCKNOT_SNAPSHOT_VERSION       2
+#define BLOCKNOT_SNAPSHOT_HEADER_SIZE   4U
+#define BLOCKNOT_SNAPSHOT_RECORD_SIZE   47U
+#define BLOCKNOT_SNAPSHOT_SIZE(count)   (BLOCKNOT_SNAPSHOT_HEADER_SIZE + ((count) * BLOCKNOT_SNAPSHOT_RECORD_SIZE))
 
 class BlockNot {
 #define TIME_PASSED getTimeSinceLastReset()
@@ -153,6 +315,10 @@ public:
     BlockNot(unsigned long time, unsigned long stoppedReturnValue, BlockNotUnit units, BlockNotGlobal globalReset,
              BlockNotState state);
 
+    BlockNot(BlockNotListing listing, unsigned long time, BlockNotState state);
+
+    BlockNot(BlockNotListing listing, unsigned long time, BlockNotUnit units = MILLISECONDS, BlockNotState state = RUNNING);
+
     /**
      * Public Methods
      */
@@ -177,6 +343,20 @@ public:
 
     void setFirstTriggerResponse(bool response);
 
+    void setOverrunPolicy(BlockNotOverrun policy, unsigned long burstLimit = NO_LIMIT);
+
+    BlockNotOverrun getOverrunPolicy() const;
+
+    unsigned long getOverrunCount() const;
+
+    void clearOverrunCount();
+
+    unsigned long getPendingCatchUps() const;
+
+    BlockNotAwait after(unsigned long time);
+
+    BlockNotAwait next();
+
     unsigned long getNextTriggerTime() const;
 
     unsigned long getTimeUntilTrigger() const;
@@ -223,65 +403,157 @@ public:
 
     BlockNotUnit getBaseUnits() const;
 
+    size_t snapshot(uint8_t *buffer, size_t size) const;
+
+    bool restore(const uint8_t *buffer, size_t size, unsigned long sleptMillis = 0);
+
+    static size_t snapshotAll(uint8_t *buffer, size_t size);
+
+    static bool restoreAll(const uint8_t *buffer, size_t size, unsigned long sleptMillis = 0);
+
+    static uint8_t getTimerCount();
+
+    static void setClock(BlockNotClock millisSource = nullptr, BlockNotClock microsSource = nullptr);
+
+    static void setClockCorrection(long ppb);
+
+    static long getClockCorrection();
+
+    static unsigned long getRawMillis();
+
+    static unsigned long getRawMicros();
+
+    static uint8_t getTableCount();
+
+    bool removeFromTimerList();
+
+    template<typename Visit>
+    static void forEachTimer(Visit visit);
+
+    template<typename Visit>
+    static void forEachDeadline(Visit visit);
+
+    static bool addWakeupSource(BlockNotWakeupSource source, const void *owner);
+
+    static bool removeWakeupSource(const void *owner);
+
+    unsigned long getRawTimeUntilTrigger() const;
+
+    unsigned long getRawElapsed() const;
+
+    unsigned long getRawDuration() const;
+
+    BlockNotStatus status() const;
+
+    BlockNotDeadline deadline() const;
+
+    static unsigned long getMicrosUntilNextTrigger();
+
+    static unsigned long getMicrosUntilNextWakeup();
+
+    static BlockNotUnit getTickUnits(BlockNotUnit units);
+
+    static uint64_t ticksToMicros(unsigned long ticks, BlockNotUnit units);
+
+    void setSlack(unsigned long time);
+
+    unsigned long getSlack() const;
+
+    unsigned long getRawSlack() const;
+
+    static void setCoalescing(bool enabled);
+
+    static bool isCoalescing();
+
+    static void setTraceHook(BlockNotTraceHook hook = nullptr);
+
+    static unsigned long getCycles();
+
+    static void setCycleFrequency(unsigned long hz);
+
+    static unsigned long getCycleFrequency();
+
+    static unsigned long calibrateCycleFrequency(unsigned long windowMicros = 10000);
+
     static void getHelp(Print &output, bool haltCode = false);
 
     static void getHelp(bool haltCode = false);
 
     class cTime {
     public:
-        double seconds = 0.0; // Central storage for time in seconds
-
         // Class for milliseconds
         class milli_t {
-            double &seconds;
+            cTime &time;
 
         public:
-            milli_t(double &s) : seconds(s) {
+            milli_t(cTime &t) : time(t) {
             }
 
             milli_t &operator=(double ms) {
-                seconds = ms * 0.001; // Convert milliseconds to seconds
+                time.setSeconds(ms * 0.001); // Convert milliseconds to seconds
                 return *this;
             }
 
             operator double() const {
-                return seconds * 1000.0; // Convert seconds to milliseconds
+                return time.getSeconds() * 1000.0; // Convert seconds to milliseconds
             }
         };
 
         // Class for microseconds
         class micro_t {
-            double &seconds;
+            cTime &time;
 
         public:
-            micro_t(double &s) : seconds(s) {
+            micro_t(cTime &t) : time(t) {
             }
 
             micro_t &operator=(double us) {
-                seconds = us * 0.000001; // Convert microseconds to seconds
+                time.setSeconds(us * 0.000001); // Convert microseconds to seconds
+                return *this;
+            }
+
+            operator double() const {
+                return time.getSeconds() * 1000000.0; // Convert seconds to microseconds
+            }
+        };
+
+        /*
+         * Class for CPU cycles. A time set in cycles is kept in cycles, so it doesn't need the
+         * cycle frequency until it is read in other units, and setCycleFrequency() can't change it.
+         */
+        class cycles_t {
+            cTime &time;
+
+        public:
+            cycles_t(cTime &t) : time(t) {
+            }
+
+            cycles_t &operator=(double cycles) {
+                time.value = cycles;
+                time.inCycles = true;
                 return *this;
             }
 
             operator double() const {
-                return seconds * 1000000.0; // Convert seconds to microseconds
+                return time.inCycles ? time.value : time.value * static_cast<double>(getCycleFrequency()); // Convert seconds to cycles
             }
         };
 
         // Class for minutes
         class minutes_t {
-            double &seconds;
+            cTime &time;
 
         public:
-            minutes_t(double &s) : seconds(s) {
+            minutes_t(cTime &t) : time(t) {
             }
 
             minutes_t &operator=(double mins) {
-                seconds = mins * 60.0; // Convert minutes to seconds
+                time.setSeconds(mins * 60.0); // Convert minutes to seconds
                 return *this;
             }
 
             operator double() const {
-                return seconds / 60.0; // Convert seconds to minutes
+                return time.getSeconds() / 60.0; // Convert seconds to minutes
             }
         };
 
@@ -289,70 +561,158 @@ public:
 
         milli_t millis;
         micro_t micros;
+        cycles_t cycles;
         minutes_t minutes;
 
         // Constructor
-        cTime() : millis(seconds), micros(seconds), minutes(seconds) {
+        cTime() : millis(*this), micros(*this), cycles(*this), minutes(*this) {
         }
 
         // Getter for seconds
-        double getSeconds() const { return seconds; }
+        double getSeconds() const { return inCycles ? value / static_cast<double>(getCycleFrequency()) : value; }
 
         // Setter for seconds
-        void setSeconds(double s) { seconds = s; }
+        void setSeconds(double s) {
+            value = s;
+            inCycles = false;
+        }
+
+        // True when the time was set in cycles and is kept that way
+        bool isCycles() const { return inCycles; }
+
+    private:
+        double value = 0.0; // Central storage for time in seconds, or in cycles when set in cycles
+        bool inCycles = false;
     };
 
+#ifndef BLOCKNOT_NO_TIMER_LIST
     static BlockNot *firstTimer;
     static BlockNot *currentTimer;
-    BlockNot *nextTimer;
+    BlockNot *nextTimer = nullptr;
+#endif
 
 private:
     /**
      * Private Variables and Methods
      */
-    unsigned long startTime;
-    unsigned long millisOffset;
-    unsigned long microsOffset;
-    unsigned long timerStoppedReturnValue;
-    unsigned long lastDuration;
-    int totalMissedDurations;
-    bool onceTriggered;
-    bool triggerOnNext;
-    bool firstTriggerResponse;
-    bool speedCompensation;
-    unsigned long compTime;
-    unsigned long newStartTimeMillis;
-    unsigned long newStartTimeMicros;
+    unsigned long startTime = 0;
+    unsigned long millisOffset = 0;
+    unsigned long microsOffset = 0;
+    unsigned long timerStoppedReturnValue = 0;
+    unsigned long lastDuration = 0;
+    int totalMissedDurations = 0;
+    bool onceTriggered = false;
+    bool triggerOnNext = false;
+    bool firstTriggerResponse = false;
+    bool speedCompensation = false;
+    unsigned long compTime = 0;
+    unsigned long newStartTimeMillis = 0;
+    unsigned long newStartTimeMicros = 0;
 
     static BlockNotGlobal global;
+    static BlockNotClock millisClock;
+    static BlockNotClock microsClock;
+    static bool coalescing;
+    static long clockPpb;
+    static int32_t clockAdjust;
+    static BlockNotTraceHook traceHook;
+    static unsigned long cycleFrequency;
+    static BlockNotWakeupSource wakeupSources[BLOCKNOT_WAKEUP_SOURCES];
+    static const void *wakeupOwners[BLOCKNOT_WAKEUP_SOURCES];
+    static uint8_t wakeupSourceCount;
+    unsigned long slackTicks = 0;
+    unsigned long rawDuration = 0;
+    BlockNotOverrun overrunPolicy = OVERRUN_DEFAULT;
+    unsigned long overrunLimit = NO_LIMIT;
+    unsigned long overrunCount = 0;
+    unsigned long catchUpInterval = 0;
+    unsigned long lastCatchUp = 0;
     BlockNotUnit baseUnits;
     cTime duration;
     cTime stopTime;
     BlockNotState timerState;
 
+    static unsigned long clockMillis();
+
+    static unsigned long clockMicros();
+
+    static unsigned long clockCycles();
+
+    unsigned long clockTicks() const;
+
+    unsigned long tickOffset() const;
+
+    double ticksOf(const cTime &timeValue) const;
+
+    void setTicks(cTime &timeValue, double ticks) const;
+
     void resetTimer(unsigned long newStartTime);
 
+    void restartTimer(unsigned long newStartTime);
+
+    void traceEvent(BlockNotEvent event) const;
+
     void initDuration(unsigned long time);
 
     void initDuration(unsigned long time, BlockNotUnit desiredUnits);
 
     unsigned long timeSinceReset() const;
 
+    unsigned long nowTicks() const;
+
+    void updateRawDuration();
+
+    unsigned long periodsSinceReset() const;
+
+    bool triggeredWithPolicy();
+
     bool hasTriggered();
 
     bool hasNotTriggered() const;
 
     void addToTimerList();
 
+    static BlockNot *const *tableBegin();
+
+    static BlockNot *const *tableEnd();
+
     unsigned long timeTillTrigger() const;
 
     unsigned long remaining() const;
 
+    static unsigned long nextTriggerMicros(bool withSlack);
+
     unsigned long getDurationTriggerStartTime() const;
 
     unsigned long convertUnits(const cTime &timeValue) const;
+
+    void writeRecord(uint8_t *record) const;
+
+    void readRecord(const uint8_t *record, unsigned long sleptMillis);
 };
 
+template<typename Visit>
+void BlockNot::forEachTimer(Visit visit) {
+    // The global reset list first, then the timer table, so the order never changes between calls
+#ifndef BLOCKNOT_NO_TIMER_LIST
+    for (BlockNot *current = firstTimer; current != nullptr; current = current->nextTimer)
+        visit(*current);
+#endif
+    for (BlockNot *const *entry = tableBegin(); entry != tableEnd(); entry++)
+        visit(**entry);
+}
+
+template<typename Visit>
+void BlockNot::forEachDeadline(Visit visit) {
+    // The timers in forEachTimer() order, then the deadlines of every wakeup source
+    forEachTimer([&visit](const BlockNot &timer) { visit(timer.deadline()); });
+    const BlockNotDeadlineVisit each = [](const BlockNotDeadline &deadline, void *context) {
+        (*static_cast<Visit *>(context))(deadline);
+    };
+    for (uint8_t i = 0; i < wakeupSourceCount; i++)
+        wakeupSources[i](wakeupOwners[i], each, &visit);
+}
+
 /**
  * Global methods affecting all instances of the BlockNot class.
  */
@@ -0,0 +1,94 @@
+/**
+ * BlockNotCalibrator measures how fast the local clock runs against a reference
+ * (a GPS PPS pulse, a 1 Hz RTC output or NTP corrected time) and corrects the rate
+ * of the clock that every BlockNot timer uses.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotCalibrator.h>
+
+/**
+ * Constructors
+ */
+
+BlockNotCalibrator::BlockNotCalibrator(const uint8_t samples, const bool autoApply) : samples(samples == 0 ? 1 : samples), autoApply(autoApply) {
+    ppb = 0;
+    calibrated = false;
+    restart();
+}
+
+/**
+ * Public Methods
+ */
+
+bool BlockNotCalibrator::referencePulse(const unsigned long periodMicros) {
+    // Pulses are timed against the raw micros() - the correction must not measure itself
+    const unsigned long now = BlockNot::getRawMicros();
+    const bool first = !started;
+    const unsigned long localDelta = static_cast<uint32_t>(now - lastLocal);
+    lastLocal = now;
+    started = true;
+    return !first && addSample(localDelta, periodMicros);
+}
+
+bool BlockNotCalibrator::referenceTime(const unsigned long referenceMillis) {
+    const unsigned long now = BlockNot::getRawMillis();
+    const bool first = !started;
+    const unsigned long localDelta = static_cast<uint32_t>(now - lastLocal);
+    const unsigned long referenceDelta = static_cast<uint32_t>(referenceMillis - lastReference);
+    lastLocal = now;
+    lastReference = referenceMillis;
+    started = true;
+    return !first && addSample(localDelta, referenceDelta);
+}
+
+bool BlockNotCalibrator::isCalibrated() const {
+    return calibrated;
+}
+
+long BlockNotCalibrator::getPpb() const {
+    return ppb;
+}
+
+void BlockNotCalibrator::apply() const {
+    BlockNot::setClockCorrection(ppb);
+}
+
+void BlockNotCalibrator::restart() {
+    count = 0;
+    started = false;
+    lastLocal = 0;
+    lastReference = 0;
+    localTotal = 0;
+    referenceTotal = 0;
+}
+
+/**
+ * Private Methods
+ */
+
+bool BlockNotCalibrator::addSample(const unsigned long localDelta, const unsigned long referenceDelta) {
+    /*
+     * Once enough reference periods have been collected, the rate error is the difference
+     * between the reference time and the local time, relative to the local time. A local
+     * clock that runs slow gives a positive correction, which speeds it up.
+     */
+    if (localDelta == 0) return false;
+    localTotal += localDelta;
+    referenceTotal += referenceDelta;
+    if (++count < samples) return false;
+    const int64_t error = static_cast<int64_t>(referenceTotal) - static_cast<int64_t>(localTotal);
+    ppb = static_cast<long>(error * 1000000000LL / static_cast<int64_t>(localTotal));
+    calibrated = true;
+    if (autoApply) apply();
+    count = 0;
+    localTotal = 0;
+    referenceTotal = 0;
+    return true;
+}
@@ -0,0 +1,55 @@
+/**
+ * BlockNotCalibrator measures how fast the local clock runs against a reference
+ * (a GPS PPS pulse, a 1 Hz RTC output or NTP corrected time) and corrects the rate
+ * of the clock that every BlockNot timer uses.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotCalibrator_h
+#define BlockNotCalibrator_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#define ONE_SECOND_PULSE    1000000UL
+#define AUTO_APPLY          true
+#define MANUAL_APPLY        false
+
+class BlockNotCalibrator {
+public:
+    explicit BlockNotCalibrator(uint8_t samples = 8, bool autoApply = AUTO_APPLY);
+
+    bool referencePulse(unsigned long periodMicros = ONE_SECOND_PULSE);
+
+    bool referenceTime(unsigned long referenceMillis);
+
+    bool isCalibrated() const;
+
+    long getPpb() const;
+
+    void apply() const;
+
+    void restart();
+
+private:
+    uint8_t samples;
+    bool autoApply;
+    uint8_t count;
+    bool started;
+    bool calibrated;
+    long ppb;
+    unsigned long lastLocal;
+    unsigned long lastReference;
+    uint64_t localTotal;
+    uint64_t referenceTotal;
+
+    bool addSample(unsigned long localDelta, unsigned long referenceDelta);
+};
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * BlockNotChain lets you describe how your timers depend on each other - when
+ * this one triggers, start that one, stop another one, reset a third - and then
+ * takes care of it for you. Only the timers that are running get checked, so a
+ * timer waiting further down a chain costs nothing until it is started.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotChain.h>
+
+/**
+ * Constructors
+ */
+
+BlockNotChain::BlockNotChain() : timerCount(0), linkCount(0), activeCount(0) {
+}
+
+/**
+ * Public Methods
+ */
+
+bool BlockNotChain::add(BlockNot &timer, const BlockNotChainMode mode, const BlockNotHandler handler) {
+    const uint8_t member = findOrAdd(timer);
+    if (member == NOT_IN_CHAIN) return false;
+    members[member].mode = mode;
+    members[member].handler = handler;
+    return true;
+}
+
+bool BlockNotChain::link(BlockNot &from, const BlockNotChainAction action, BlockNot &to) {
+    if (linkCount >= BLOCKNOT_CHAIN_LINKS) return false;
+    const uint8_t source = findOrAdd(from);
+    const uint8_t target = findOrAdd(to);
+    if (source == NOT_IN_CHAIN || target == NOT_IN_CHAIN) return false;
+    const Link newLink = {source, target, action};
+    links[linkCount++] = newLink;
+    return true;
+}
+
+void BlockNotChain::start(BlockNot &timer) {
+    timer.start(WITH_RESET);
+    const uint8_t member = find(timer);
+    if (member != NOT_IN_CHAIN) activate(member);
+}
+
+void BlockNotChain::stop(BlockNot &timer) {
+    timer.stop();
+    const uint8_t member = find(timer);
+    if (member != NOT_IN_CHAIN) deactivate(member);
+}
+
+void BlockNotChain::sync() {
+    // For timers that were started or stopped directly instead of through the chain
+    activeCount = 0;
+    for (uint8_t member = 0; member < timerCount; member++) {
+        if (members[member].timer->isRunning()) active[activeCount++] = member;
+    }
+}
+
+uint8_t BlockNotChain::poll() {
+    /*
+     * Only running timers are checked. The ones that triggered are collected first and
+     * their links followed afterward, so a timer started by a link is not checked until
+     * the next pass, and the active list does not change under our feet. Any timer that a
+     * link starts, stops or resets earlier in the same pass has had its trigger taken
+     * over by that link, so it doesn't fire, and only the ones that did count.
+     */
+    uint8_t triggered[BLOCKNOT_CHAIN_TIMERS];
+    bool touched[BLOCKNOT_CHAIN_TIMERS];
+    uint8_t count = 0;
+    for (uint8_t member = 0; member < timerCount; member++) touched[member] = false;
+    for (uint8_t i = 0; i < activeCount; i++) {
+        if (members[active[i]].timer->triggered()) triggered[count++] = active[i];
+    }
+    uint8_t fired = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (touched[triggered[i]]) continue;
+        if (fire(triggered[i], touched)) fired++;
+    }
+    return fired;
+}
+
+uint8_t BlockNotChain::getTimerCount() const {
+    return timerCount;
+}
+
+uint8_t BlockNotChain::getLinkCount() const {
+    return linkCount;
+}
+
+uint8_t BlockNotChain::getActiveCount() const {
+    return activeCount;
+}
+
+/**
+ * Private Methods
+ */
+
+uint8_t BlockNotChain::find(const BlockNot &timer) const {
+    for (uint8_t member = 0; member < timerCount; member++) {
+        if (members[member].timer == &timer) return member;
+    }
+    return NOT_IN_CHAIN;
+}
+
+uint8_t BlockNotChain::findOrAdd(BlockNot &timer) {
+    uint8_t member = find(timer);
+    if (member != NOT_IN_CHAIN || timerCount >= BLOCKNOT_CHAIN_TIMERS) return member;
+    member = timerCount++;
+    const Member newMember = {&timer, nullptr, CHAIN_REPEAT};
+    members[member] = newMember;
+    if (timer.isRunning()) activate(member);
+    return member;
+}
+
+void BlockNotChain::activate(const uint8_t member) {
+    for (uint8_t i = 0; i < activeCount; i++) {
+        if (active[i] == member) return;
+    }
+    active[activeCount++] = member;
+}
+
+void BlockNotChain::deactivate(const uint8_t member) {
+    for (uint8_t i = 0; i < activeCount; i++) {
+        if (active[i] != member) continue;
+        active[i] = active[--activeCount];
+        return;
+    }
+}
+
+bool BlockNotChain::fire(const uint8_t member, bool *touched) {
+    /*
+     * A one shot timer stops once it triggers, then the handler runs, then the links are
+     * followed in the order they were made - so a link can start the same timer again.
+     * A one shot is only stopped here, after this check, so the check only catches a timer
+     * that a handler stopped. Every link target is marked as touched for the rest of the pass.
+     */
+    if (!members[member].timer->isRunning()) return false;
+    if (members[member].mode == CHAIN_ONE_SHOT) stop(*members[member].timer);
+    if (members[member].handler != nullptr) members[member].handler(*members[member].timer);
+    for (uint8_t i = 0; i < linkCount; i++) {
+        if (links[i].from != member) continue;
+        BlockNot &target = *members[links[i].to].timer;
+        touched[links[i].to] = true;
+        switch (links[i].action) {
+            case CHAIN_START: {
+                start(target);
+                break;
+            }
+            case CHAIN_STOP: {
+                stop(target);
+                break;
+            }
+            case CHAIN_RESET: {
+                target.reset();
+                break;
+            }
+        }
+    }
+    return true;
+}
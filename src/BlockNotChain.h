@@ -0,0 +1,101 @@
+/**
+ * BlockNotChain lets you describe how your timers depend on each other - when
+ * this one triggers, start that one, stop another one, reset a third - and then
+ * takes care of it for you. Only the timers that are running get checked, so a
+ * timer waiting further down a chain costs nothing until it is started.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotChain_h
+#define BlockNotChain_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+/**
+ * Chain sizes - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_CHAIN_TIMERS
+#define BLOCKNOT_CHAIN_TIMERS       16
+#endif
+
+#ifndef BLOCKNOT_CHAIN_LINKS
+#define BLOCKNOT_CHAIN_LINKS        24
+#endif
+
+enum BlockNotChainAction {
+    chainStart, chainStop, chainReset
+};
+
+enum BlockNotChainMode {
+    chainRepeat, chainOneShot
+};
+
+#define CHAIN_START         BlockNotChainAction::chainStart
+#define CHAIN_STOP          BlockNotChainAction::chainStop
+#define CHAIN_RESET         BlockNotChainAction::chainReset
+#define CHAIN_REPEAT        BlockNotChainMode::chainRepeat
+#define CHAIN_ONE_SHOT      BlockNotChainMode::chainOneShot
+#define NOT_IN_CHAIN        0xFF
+
+class BlockNotChain {
+public:
+    BlockNotChain();
+
+    bool add(BlockNot &timer, BlockNotChainMode mode = CHAIN_REPEAT, BlockNotHandler handler = nullptr);
+
+    bool link(BlockNot &from, BlockNotChainAction action, BlockNot &to);
+
+    void start(BlockNot &timer);
+
+    void stop(BlockNot &timer);
+
+    void sync();
+
+    uint8_t poll();
+
+    uint8_t getTimerCount() const;
+
+    uint8_t getLinkCount() const;
+
+    uint8_t getActiveCount() const;
+
+private:
+    struct Member {
+        BlockNot *timer;
+        BlockNotHandler handler;
+        BlockNotChainMode mode;
+    };
+
+    struct Link {
+        uint8_t from;
+        uint8_t to;
+        BlockNotChainAction action;
+    };
+
+    Member members[BLOCKNOT_CHAIN_TIMERS];
+    Link links[BLOCKNOT_CHAIN_LINKS];
+    uint8_t active[BLOCKNOT_CHAIN_TIMERS];
+    uint8_t timerCount;
+    uint8_t linkCount;
+    uint8_t activeCount;
+
+    uint8_t find(const BlockNot &timer) const;
+
+    uint8_t findOrAdd(BlockNot &timer);
+
+    void activate(uint8_t member);
+
+    void deactivate(uint8_t member);
+
+    bool fire(uint8_t member, bool *touched);
+};
+
+#endif
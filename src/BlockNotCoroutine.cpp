@@ -0,0 +1,106 @@
+/**
+ * BlockNotCoroutine lets a C++20 coroutine wait on a BlockNot timer with
+ * co_await timer.after(250) or co_await timer.next(), and a small executor
+ * resumes it once the timer triggers. Coroutine frames come from a fixed pool,
+ * so nothing is allocated on the heap.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotCoroutine.h>
+
+#ifdef BLOCKNOT_COROUTINES
+
+#define NO_FRAME 0xFF
+
+static_assert(BLOCKNOT_CORO_FRAMES > 0 && BLOCKNOT_CORO_FRAMES < NO_FRAME, "BLOCKNOT_CORO_FRAMES must be between 1 and 254");
+
+/**
+ * Global Variables
+ */
+
+BlockNotFramePool::Frame BlockNotFramePool::frames[BLOCKNOT_CORO_FRAMES];
+uint8_t BlockNotFramePool::nextFree[BLOCKNOT_CORO_FRAMES];
+uint8_t BlockNotFramePool::firstFree = NO_FRAME;
+uint8_t BlockNotFramePool::freeCount = 0;
+bool BlockNotFramePool::initialized = false;
+
+BlockNotExecutor::Slot BlockNotExecutor::slots[BLOCKNOT_CORO_FRAMES];
+
+/**
+ * Frame Pool
+ */
+
+void *BlockNotFramePool::allocate(const size_t size) {
+    if (!initialized) {
+        for (uint8_t i = 0; i < BLOCKNOT_CORO_FRAMES; i++)
+            nextFree[i] = (i + 1 < BLOCKNOT_CORO_FRAMES) ? i + 1 : NO_FRAME;
+        firstFree = 0;
+        freeCount = BLOCKNOT_CORO_FRAMES;
+        initialized = true;
+    }
+    if (size > BLOCKNOT_CORO_FRAME_SIZE || firstFree == NO_FRAME) return nullptr;
+    const uint8_t index = firstFree;
+    firstFree = nextFree[index];
+    freeCount--;
+    return frames[index].bytes;
+}
+
+void BlockNotFramePool::release(void *frame) {
+    if (frame == nullptr) return;
+    const uint8_t index = static_cast<Frame *>(frame) - frames;
+    nextFree[index] = firstFree;
+    firstFree = index;
+    freeCount++;
+}
+
+uint8_t BlockNotFramePool::getFree() {
+    return initialized ? freeCount : BLOCKNOT_CORO_FRAMES;
+}
+
+/**
+ * Executor
+ */
+
+void BlockNotExecutor::wait(BlockNot *timer, const std::coroutine_handle<BlockNotTask::promise_type> handle) {
+    static_assert(sizeof(slots) / sizeof(slots[0]) >= BLOCKNOT_CORO_FRAMES, "every coroutine frame needs a wait slot");
+    for (Slot &slot : slots) {
+        if (slot.timer == nullptr) {
+            slot.timer = timer;
+            slot.handle = handle;
+            return;
+        }
+    }
+}
+
+uint8_t BlockNotExecutor::poll() {
+    /*
+     * A slot is cleared before its coroutine is resumed, because the coroutine will
+     * usually co_await again straight away and may land in the very same slot.
+     */
+    uint8_t resumed = 0;
+    for (Slot &slot : slots) {
+        if (slot.timer != nullptr && slot.timer->triggered()) {
+            const std::coroutine_handle<> handle = slot.handle;
+            slot.timer = nullptr;
+            handle.resume();
+            resumed++;
+        }
+    }
+    return resumed;
+}
+
+uint8_t BlockNotExecutor::getWaiting() {
+    uint8_t waiting = 0;
+    for (const Slot &slot : slots) {
+        if (slot.timer != nullptr) waiting++;
+    }
+    return waiting;
+}
+
+#endif
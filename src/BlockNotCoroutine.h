@@ -0,0 +1,138 @@
+/**
+ * BlockNotCoroutine lets a C++20 coroutine wait on a BlockNot timer with
+ * co_await timer.after(250) or co_await timer.next(), and a small executor
+ * resumes it once the timer triggers. Coroutine frames come from a fixed pool,
+ * so nothing is allocated on the heap.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotCoroutine_h
+#define BlockNotCoroutine_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && __cplusplus >= 202002L
+#define BLOCKNOT_COROUTINES
+#endif
+#endif
+
+#ifdef BLOCKNOT_COROUTINES
+
+#include <coroutine>
+#include <stddef.h>
+
+/**
+ * Pool sizes - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_CORO_FRAMES
+#define BLOCKNOT_CORO_FRAMES        8
+#endif
+
+#ifndef BLOCKNOT_CORO_FRAME_SIZE
+#define BLOCKNOT_CORO_FRAME_SIZE    256
+#endif
+
+class BlockNotFramePool {
+public:
+    static void *allocate(size_t size);
+
+    static void release(void *frame);
+
+    static uint8_t getFree();
+
+private:
+    struct alignas(max_align_t) Frame {
+        uint8_t bytes[BLOCKNOT_CORO_FRAME_SIZE];
+    };
+
+    static Frame frames[BLOCKNOT_CORO_FRAMES];
+    static uint8_t nextFree[BLOCKNOT_CORO_FRAMES];
+    static uint8_t firstFree;
+    static uint8_t freeCount;
+    static bool initialized;
+};
+
+/**
+ * The return type of every coroutine that waits on BlockNot timers. Coroutines start
+ * running as soon as they are called and free their frame when they finish. If the
+ * frame pool is full, the coroutine does not run at all and started() returns false.
+ */
+class BlockNotTask {
+public:
+    struct promise_type {
+        BlockNotTask get_return_object() { return BlockNotTask(true); }
+
+        static BlockNotTask get_return_object_on_allocation_failure() { return BlockNotTask(false); }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+
+        void unhandled_exception() {}
+
+        static void *operator new(size_t size) noexcept { return BlockNotFramePool::allocate(size); }
+
+        static void operator delete(void *frame) noexcept { BlockNotFramePool::release(frame); }
+    };
+
+    bool started() const { return isStarted; }
+
+private:
+    explicit BlockNotTask(const bool started) : isStarted(started) {}
+
+    bool isStarted;
+};
+
+/**
+ * Keeps the coroutines that are waiting on a timer. There is a slot for every frame in the
+ * pool, and only BlockNotTask coroutines can wait, so a waiting coroutine always has a slot.
+ */
+class BlockNotExecutor {
+public:
+    static void wait(BlockNot *timer, std::coroutine_handle<BlockNotTask::promise_type> handle);
+
+    static uint8_t poll();
+
+    static uint8_t getWaiting();
+
+private:
+    struct Slot {
+        BlockNot *timer;
+        std::coroutine_handle<> handle;
+    };
+
+    static Slot slots[BLOCKNOT_CORO_FRAMES];
+};
+
+class BlockNotAwaiter {
+public:
+    explicit BlockNotAwaiter(BlockNot *timer) : timer(timer) {}
+
+    bool await_ready() const { return timer->triggered(); }
+
+    void await_suspend(const std::coroutine_handle<BlockNotTask::promise_type> handle) const { BlockNotExecutor::wait(timer, handle); }
+
+    void await_resume() const {}
+
+private:
+    BlockNot *timer;
+};
+
+inline BlockNotAwaiter operator co_await(const BlockNotAwait await) {
+    return BlockNotAwaiter(await.timer);
+}
+
+#endif
+
+#endif
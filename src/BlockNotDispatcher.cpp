@@ -0,0 +1,130 @@
+/**
+ * BlockNotDispatcher runs the handlers of your timers in order of priority, and
+ * stops for the loop pass once its time budget is used up, leaving the less
+ * important handlers for the next pass. Under overload, the timers that matter
+ * still get handled on time and loop() still comes around quickly.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotDispatcher.h>
+
+/**
+ * Constructors
+ */
+
+BlockNotDispatcher::BlockNotDispatcher(const unsigned long budgetMicros) : timerCount(0), budget(budgetMicros), handled(0), deferred(0), longestPass(0) {
+}
+
+/**
+ * Public Methods
+ */
+
+bool BlockNotDispatcher::add(BlockNot &timer, const BlockNotHandler handler, const uint8_t priority) {
+    if (timerCount >= BLOCKNOT_DISPATCH_TIMERS || handler == nullptr) return false;
+    const Entry entry = {&timer, handler, priority, false};
+    entries[timerCount] = entry;
+    sort(timerCount++);
+    return true;
+}
+
+bool BlockNotDispatcher::setPriority(const BlockNot &timer, const uint8_t priority) {
+    for (uint8_t i = 0; i < timerCount; i++) {
+        if (entries[i].timer != &timer) continue;
+        entries[i].priority = priority;
+        sort(i);
+        return true;
+    }
+    return false;
+}
+
+void BlockNotDispatcher::setBudget(const unsigned long budgetMicros) {
+    budget = budgetMicros;
+}
+
+unsigned long BlockNotDispatcher::getBudget() const {
+    return budget;
+}
+
+uint8_t BlockNotDispatcher::dispatch() {
+    /*
+     * Every timer that is not already waiting gets polled first, so nothing that comes due
+     * is missed, even when its handler has to wait. Then the waiting handlers run from the
+     * highest priority down until the budget is used up. The first one always runs, so the
+     * most important work can't be starved by a budget that is too small. A handler is
+     * never interrupted - the budget is checked between handlers - so keep them short.
+     */
+    const unsigned long start = BlockNot::getRawMicros();
+    for (uint8_t i = 0; i < timerCount; i++) {
+        if (!entries[i].pending && entries[i].timer->triggered())
+            entries[i].pending = true;
+    }
+    uint8_t ran = 0;
+    for (uint8_t i = 0; i < timerCount; i++) {
+        if (!entries[i].pending) continue;
+        if (ran > 0 && budget != NO_BUDGET && static_cast<uint32_t>(BlockNot::getRawMicros() - start) >= budget) {
+            deferred += getPending();
+            break;
+        }
+        entries[i].pending = false;
+        entries[i].handler(*entries[i].timer);
+        ran++;
+    }
+    handled += ran;
+    const unsigned long pass = static_cast<uint32_t>(BlockNot::getRawMicros() - start);
+    if (pass > longestPass) longestPass = pass;
+    return ran;
+}
+
+uint8_t BlockNotDispatcher::getTimerCount() const {
+    return timerCount;
+}
+
+uint8_t BlockNotDispatcher::getPending() const {
+    uint8_t pending = 0;
+    for (uint8_t i = 0; i < timerCount; i++) {
+        if (entries[i].pending) pending++;
+    }
+    return pending;
+}
+
+unsigned long BlockNotDispatcher::getHandled() const {
+    return handled;
+}
+
+unsigned long BlockNotDispatcher::getDeferred() const {
+    return deferred;
+}
+
+unsigned long BlockNotDispatcher::getLongestPass() const {
+    return longestPass;
+}
+
+void BlockNotDispatcher::resetCounters() {
+    handled = 0;
+    deferred = 0;
+    longestPass = 0;
+}
+
+/**
+ * Private Methods
+ */
+
+void BlockNotDispatcher::sort(uint8_t index) {
+    // One entry changed, so it only has to move up or down into place. Equal priorities keep the order they were added in
+    const Entry entry = entries[index];
+    while (index > 0 && entries[index - 1].priority < entry.priority) {
+        entries[index] = entries[index - 1];
+        index--;
+    }
+    while (index + 1 < timerCount && entries[index + 1].priority >= entry.priority) {
+        entries[index] = entries[index + 1];
+        index++;
+    }
+    entries[index] = entry;
+}
@@ -0,0 +1,79 @@
+/**
+ * BlockNotDispatcher runs the handlers of your timers in order of priority, and
+ * stops for the loop pass once its time budget is used up, leaving the less
+ * important handlers for the next pass. Under overload, the timers that matter
+ * still get handled on time and loop() still comes around quickly.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotDispatcher_h
+#define BlockNotDispatcher_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+/**
+ * Dispatcher size - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_DISPATCH_TIMERS
+#define BLOCKNOT_DISPATCH_TIMERS    16
+#endif
+
+#define NO_BUDGET                   0
+#define PRIORITY_LOW                0
+#define PRIORITY_NORMAL             128
+#define PRIORITY_HIGH               255
+
+class BlockNotDispatcher {
+public:
+    explicit BlockNotDispatcher(unsigned long budgetMicros = NO_BUDGET);
+
+    bool add(BlockNot &timer, BlockNotHandler handler, uint8_t priority = PRIORITY_NORMAL);
+
+    bool setPriority(const BlockNot &timer, uint8_t priority);
+
+    void setBudget(unsigned long budgetMicros);
+
+    unsigned long getBudget() const;
+
+    uint8_t dispatch();
+
+    uint8_t getTimerCount() const;
+
+    uint8_t getPending() const;
+
+    unsigned long getHandled() const;
+
+    unsigned long getDeferred() const;
+
+    unsigned long getLongestPass() const;
+
+    void resetCounters();
+
+private:
+    struct Entry {
+        BlockNot *timer;
+        BlockNotHandler handler;
+        uint8_t priority;
+        bool pending;
+    };
+
+    Entry entries[BLOCKNOT_DISPATCH_TIMERS];
+    uint8_t timerCount;
+    unsigned long budget;
+
+    unsigned long handled;
+    unsigned long deferred;
+    unsigned long longestPass;
+
+    void sort(uint8_t index);
+};
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * BlockNotPool hands out timers from a fixed set that is allocated once, so
+ * short-lived timeouts can come and go at run time without new, delete or a
+ * fragmented heap. Each timer is reached through a handle that carries a
+ * generation count, so a handle that outlives its timer is caught instead of
+ * quietly pointing at whoever got that timer next.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotPool.h>
+
+static_assert(BLOCKNOT_POOL_TIMERS > 0 && BLOCKNOT_POOL_TIMERS < 0xFFFF, "BLOCKNOT_POOL_TIMERS must be between 1 and 65534");
+
+#define END_OF_LIST 0xFFFF
+
+/*
+ * A handle is the generation of its timer in the top 16 bits and the index of the
+ * timer in the bottom 16 bits. The generation goes up by one on every acquire and
+ * every release, so it is odd while the timer is handed out and even while it sits
+ * in the pool. That way a handle from before a release, a handle to a free timer
+ * and NO_HANDLE itself can never match.
+ */
+
+static BlockNotHandle makeHandle(const uint16_t generation, const uint16_t index) {
+    return static_cast<BlockNotHandle>(generation) << 16 | index;
+}
+
+/**
+ * Constructors
+ */
+
+BlockNotPool::BlockNotPool() : firstFree(0), freeCount(BLOCKNOT_POOL_TIMERS), staleCount(0) {
+    for (uint16_t i = 0; i < BLOCKNOT_POOL_TIMERS; i++) {
+        generation[i] = 0;
+        nextFree[i] = (i + 1 < BLOCKNOT_POOL_TIMERS) ? i + 1 : END_OF_LIST;
+    }
+    BlockNot::addWakeupSource(visitDeadlines, this);
+}
+
+BlockNotPool::~BlockNotPool() {
+    BlockNot::removeWakeupSource(this);
+}
+
+/**
+ * Public Methods
+ */
+
+BlockNotHandle BlockNotPool::acquire(const unsigned long duration, const BlockNotUnit units) {
+    /*
+     * A timer coming out of the pool must not carry anything over from whoever had it
+     * last, so everything a sketch could have changed goes back to the defaults before
+     * the timer is started fresh.
+     */
+    if (firstFree == END_OF_LIST) return NO_HANDLE;
+    const uint16_t index = firstFree;
+    firstFree = nextFree[index];
+    freeCount--;
+    BlockNot &timer = timers[index];
+    timer.switchTo(units);
+    timer.setMillisOffset(0);
+    timer.setMicrosOffset(0);
+    timer.disableSpeedComp();
+    timer.setFirstTriggerResponse(false);
+    timer.setOverrunPolicy(OVERRUN_DEFAULT);
+    timer.clearOverrunCount();
+    timer.setStoppedReturnValue(0);
+    timer.setSlack(0);
+    timer.setDuration(duration, NO_RESET);
+    timer.start(WITH_RESET);
+    return makeHandle(++generation[index], index);
+}
+
+bool BlockNotPool::release(const BlockNotHandle handle) {
+    const int32_t index = slotOf(handle);
+    if (index < 0) return false;
+    timers[index].stop();
+    generation[index]++;
+    nextFree[index] = firstFree;
+    firstFree = index;
+    freeCount++;
+    return true;
+}
+
+BlockNot *BlockNotPool::get(const BlockNotHandle handle) {
+    const int32_t index = slotOf(handle);
+    return index < 0 ? nullptr : &timers[index];
+}
+
+bool BlockNotPool::isValid(const BlockNotHandle handle) const {
+    return slotOf(handle) >= 0;
+}
+
+bool BlockNotPool::triggered(const BlockNotHandle handle) {
+    BlockNot *timer = get(handle);
+    return timer != nullptr && timer->triggered();
+}
+
+uint16_t BlockNotPool::getFree() const {
+    return freeCount;
+}
+
+uint16_t BlockNotPool::getCapacity() const {
+    return BLOCKNOT_POOL_TIMERS;
+}
+
+unsigned long BlockNotPool::getStaleCount() const {
+    return staleCount;
+}
+
+/**
+ * Private Methods
+ */
+
+int32_t BlockNotPool::slotOf(const BlockNotHandle handle) const {
+    const uint16_t index = handle & 0xFFFF;
+    if (index >= BLOCKNOT_POOL_TIMERS || (generation[index] & 1) == 0 || handle != makeHandle(generation[index], index)) {
+        if (handle != NO_HANDLE) staleCount++;
+        return -1;
+    }
+    return index;
+}
+
+void BlockNotPool::visitDeadlines(const void *owner, const BlockNotDeadlineVisit visit, void *context) {
+    // Timers waiting in the pool are stopped, so only the ones that are lent out and running count
+    const BlockNotPool &pool = *static_cast<const BlockNotPool *>(owner);
+    for (uint16_t i = 0; i < BLOCKNOT_POOL_TIMERS; i++) {
+        if (pool.timers[i].isRunning()) visit(pool.timers[i].deadline(), context);
+    }
+}
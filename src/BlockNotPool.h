@@ -0,0 +1,79 @@
+/**
+ * BlockNotPool hands out timers from a fixed set that is allocated once, so
+ * short-lived timeouts can come and go at run time without new, delete or a
+ * fragmented heap. Each timer is reached through a handle that carries a
+ * generation count, so a handle that outlives its timer is caught instead of
+ * quietly pointing at whoever got that timer next.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotPool_h
+#define BlockNotPool_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+/**
+ * Pool size - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_POOL_TIMERS
+#define BLOCKNOT_POOL_TIMERS    16
+#endif
+
+#define NO_HANDLE               0
+
+typedef uint32_t BlockNotHandle;
+
+class BlockNotPool {
+public:
+    BlockNotPool();
+
+    ~BlockNotPool();
+
+    BlockNotHandle acquire(unsigned long duration, BlockNotUnit units = MILLISECONDS);
+
+    bool release(BlockNotHandle handle);
+
+    BlockNot *get(BlockNotHandle handle);
+
+    bool isValid(BlockNotHandle handle) const;
+
+    bool triggered(BlockNotHandle handle);
+
+    uint16_t getFree() const;
+
+    uint16_t getCapacity() const;
+
+    unsigned long getStaleCount() const;
+
+private:
+    /**
+     * The pool keeps track of its own timers, so they are built unlisted and stopped -
+     * a plain array of BlockNot would put every one of them in the global reset list
+     */
+    class PoolTimer : public BlockNot {
+    public:
+        PoolTimer() : BlockNot(UNLISTED, 0, STOPPED) {
+        }
+    };
+
+    PoolTimer timers[BLOCKNOT_POOL_TIMERS];
+    uint16_t generation[BLOCKNOT_POOL_TIMERS];
+    uint16_t nextFree[BLOCKNOT_POOL_TIMERS];
+    uint16_t firstFree;
+    uint16_t freeCount;
+    mutable unsigned long staleCount;
+
+    int32_t slotOf(BlockNotHandle handle) const;
+
+    static void visitDeadlines(const void *owner, BlockNotDeadlineVisit visit, void *context);
+};
+
+#endif
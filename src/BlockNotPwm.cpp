@@ -0,0 +1,193 @@
+/**
+ * BlockNotPwm drives many software PWM outputs from a single MICROSECONDS timer.
+ * Every channel goes high at the start of the period, and all of the falling edges
+ * are kept in one sorted list, so each wakeup handles every channel that shares
+ * that edge at once. Changes to a pulse take effect at the start of the next period
+ * so a pulse is never cut short or stretched by an update.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotPwm.h>
+
+static_assert(BLOCKNOT_PWM_CHANNELS <= 32, "BLOCKNOT_PWM_CHANNELS can be at most 32");
+
+static void pinWriter(const uint8_t pin, const bool high) {
+    digitalWrite(pin, high ? HIGH : LOW);
+}
+
+/**
+ * Constructors
+ */
+
+BlockNotPwm::BlockNotPwm(const unsigned long periodMicros) : periodTimer(UNLISTED, periodMicros, MICROSECONDS), writer(pinWriter), channelCount(0), front(0), updatePending(false), nextEdge(0), levels(0) {
+    lists[0].count = 0;
+    lists[0].high = 0;
+    lists[1].count = 0;
+    lists[1].high = 0;
+}
+
+BlockNotPwm::~BlockNotPwm() {
+    BlockNot::removeWakeupSource(this);
+}
+
+/**
+ * Public Methods
+ */
+
+uint8_t BlockNotPwm::add(const uint8_t pin, const unsigned long pulseMicros) {
+    if (channelCount >= BLOCKNOT_PWM_CHANNELS) return NO_CHANNEL;
+    const uint8_t channel = channelCount++;
+    pins[channel] = pin;
+    setPulse(channel, pulseMicros);
+    return channel;
+}
+
+void BlockNotPwm::setPulse(const uint8_t channel, const unsigned long pulseMicros) {
+    if (channel >= channelCount) return;
+    pulses[channel] = pulseMicros;
+    build();
+}
+
+void BlockNotPwm::setDuty(const uint8_t channel, const uint8_t duty) {
+    setPulse(channel, static_cast<unsigned long>(static_cast<uint64_t>(getPeriod()) * duty / FULL_DUTY));
+}
+
+unsigned long BlockNotPwm::getPulse(const uint8_t channel) const {
+    return (channel < channelCount) ? pulses[channel] : 0;
+}
+
+unsigned long BlockNotPwm::getPeriod() const {
+    return periodTimer.getRawDuration();
+}
+
+void BlockNotPwm::setWriter(const BlockNotPwmWriter newWriter) {
+    writer = (newWriter == nullptr) ? pinWriter : newWriter;
+}
+
+void BlockNotPwm::begin() {
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        if (writer == pinWriter) pinMode(pins[channel], OUTPUT);
+        writer(pins[channel], false);
+    }
+    levels = 0;
+    periodTimer.reset();
+    startPeriod();
+    // The edges only need waking up for once they are going out
+    BlockNot::removeWakeupSource(this);
+    BlockNot::addWakeupSource(visitDeadlines, this);
+}
+
+uint8_t BlockNotPwm::poll() {
+    /*
+     * TRIGGERED_ON_DURATION keeps the periods lined up even when a poll comes in late,
+     * so the frequency does not drift with the loop. Falling edges that are due go out
+     * in order - if the loop was slow, several of them go out in the same poll.
+     */
+    uint8_t handled = 0;
+    if (periodTimer.triggeredOnDuration()) {
+        startPeriod();
+        handled++;
+    }
+    const EdgeList &list = lists[front];
+    const unsigned long elapsed = periodTimer.getRawElapsed();
+    while (nextEdge < list.count && elapsed >= list.edges[nextEdge].time) {
+        write(list.edges[nextEdge].channels, false);
+        nextEdge++;
+        handled++;
+    }
+    return handled;
+}
+
+unsigned long BlockNotPwm::getMicrosUntilNextEdge() const {
+    const EdgeList &list = lists[front];
+    const unsigned long elapsed = periodTimer.getRawElapsed();
+    const unsigned long edge = (nextEdge < list.count) ? list.edges[nextEdge].time : getPeriod();
+    return (elapsed < edge) ? edge - elapsed : 0;
+}
+
+uint8_t BlockNotPwm::getChannelCount() const {
+    return channelCount;
+}
+
+uint8_t BlockNotPwm::getEdgeCount() const {
+    return lists[front].count;
+}
+
+bool BlockNotPwm::isUpdatePending() const {
+    return updatePending;
+}
+
+/**
+ * Private Methods
+ */
+
+void BlockNotPwm::build() {
+    /*
+     * The new edges go into the list that is not in use and are swapped in at the start
+     * of the next period. Channels with the same pulse width share one edge. A pulse of
+     * zero never goes high and a pulse as long as the period never goes low.
+     */
+    EdgeList &list = lists[front ^ 1];
+    list.count = 0;
+    list.high = 0;
+    const unsigned long period = getPeriod();
+    for (uint8_t channel = 0; channel < channelCount; channel++) {
+        const unsigned long pulse = pulses[channel];
+        if (pulse == 0) continue;
+        list.high |= (1UL << channel);
+        if (pulse >= period) continue;
+        uint8_t index = 0;
+        while (index < list.count && list.edges[index].time < pulse) index++;
+        if (index < list.count && list.edges[index].time == pulse) {
+            list.edges[index].channels |= (1UL << channel);
+            continue;
+        }
+        for (uint8_t move = list.count; move > index; move--) {
+            list.edges[move] = list.edges[move - 1];
+        }
+        list.edges[index].time = pulse;
+        list.edges[index].channels = (1UL << channel);
+        list.count++;
+    }
+    updatePending = true;
+}
+
+void BlockNotPwm::startPeriod() {
+    if (updatePending) {
+        front ^= 1;
+        updatePending = false;
+    }
+    const uint32_t high = lists[front].high;
+    write(levels & ~high, false);
+    write(high, true);
+    nextEdge = 0;
+}
+
+void BlockNotPwm::write(const uint32_t channels, const bool high) {
+    // Only the channels that actually change get written
+    uint32_t changing = high ? (channels & ~levels) : (channels & levels);
+    for (uint8_t channel = 0; changing != 0; channel++, changing >>= 1) {
+        if (changing & 1UL) writer(pins[channel], high);
+    }
+    levels = high ? (levels | channels) : (levels & ~channels);
+}
+
+void BlockNotPwm::visitDeadlines(const void *owner, const BlockNotDeadlineVisit visit, void *context) {
+    // The next falling edge, or the start of the next period when every edge has gone out
+    const BlockNotPwm &pwm = *static_cast<const BlockNotPwm *>(owner);
+    const EdgeList &list = pwm.lists[pwm.front];
+    BlockNotDeadline deadline = {};
+    deadline.status.running = true;
+    deadline.status.elapsed = pwm.periodTimer.getRawElapsed();
+    deadline.status.duration = (pwm.nextEdge < list.count) ? list.edges[pwm.nextEdge].time : pwm.getPeriod();
+    deadline.status.due = deadline.status.elapsed >= deadline.status.duration;
+    deadline.status.remaining = deadline.status.due ? 0 : deadline.status.duration - deadline.status.elapsed;
+    deadline.units = MICROSECONDS;
+    visit(deadline, context);
+}
@@ -0,0 +1,97 @@
+/**
+ * BlockNotPwm drives many software PWM outputs from a single MICROSECONDS timer.
+ * Every channel goes high at the start of the period, and all of the falling edges
+ * are kept in one sorted list, so each wakeup handles every channel that shares
+ * that edge at once. Changes to a pulse take effect at the start of the next period
+ * so a pulse is never cut short or stretched by an update.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotPwm_h
+#define BlockNotPwm_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+/**
+ * Channel count - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_PWM_CHANNELS
+#define BLOCKNOT_PWM_CHANNELS       16
+#endif
+
+#define NO_CHANNEL                  0xFF
+#define FULL_DUTY                   255
+
+typedef void (*BlockNotPwmWriter)(uint8_t pin, bool high);
+
+class BlockNotPwm {
+public:
+    explicit BlockNotPwm(unsigned long periodMicros);
+
+    ~BlockNotPwm();
+
+    uint8_t add(uint8_t pin, unsigned long pulseMicros = 0);
+
+    void setPulse(uint8_t channel, unsigned long pulseMicros);
+
+    void setDuty(uint8_t channel, uint8_t duty);
+
+    unsigned long getPulse(uint8_t channel) const;
+
+    unsigned long getPeriod() const;
+
+    void setWriter(BlockNotPwmWriter writer);
+
+    void begin();
+
+    uint8_t poll();
+
+    unsigned long getMicrosUntilNextEdge() const;
+
+    uint8_t getChannelCount() const;
+
+    uint8_t getEdgeCount() const;
+
+    bool isUpdatePending() const;
+
+private:
+    struct Edge {
+        unsigned long time;
+        uint32_t channels;
+    };
+
+    struct EdgeList {
+        Edge edges[BLOCKNOT_PWM_CHANNELS];
+        uint8_t count;
+        uint32_t high;
+    };
+
+    BlockNot periodTimer;
+    BlockNotPwmWriter writer;
+    uint8_t pins[BLOCKNOT_PWM_CHANNELS];
+    unsigned long pulses[BLOCKNOT_PWM_CHANNELS];
+    uint8_t channelCount;
+    EdgeList lists[2];
+    uint8_t front;
+    bool updatePending;
+    uint8_t nextEdge;
+    uint32_t levels;
+
+    void build();
+
+    void startPeriod();
+
+    void write(uint32_t channels, bool high);
+
+    static void visitDeadlines(const void *owner, BlockNotDeadlineVisit visit, void *context);
+};
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * BlockNotRateMeter measures how often something happens - pulses from a flow meter, turns
+ * of a shaft, packets on a wire - over a window that slides along with time instead of
+ * jumping from one window to the next. The window is split into buckets that are moved
+ * along only when the meter is read, and events can be recorded from an interrupt.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotRateMeter.h>
+
+#define SLOTS (BLOCKNOT_RATE_BUCKETS + 1)
+#define COUNT_MASK 0x00FFFFFFUL
+
+static_assert(BLOCKNOT_RATE_BUCKETS > 0 && BLOCKNOT_RATE_BUCKETS < 127, "BLOCKNOT_RATE_BUCKETS must be between 1 and 126");
+
+static double secondsOf(const double amount, const BlockNotUnit units) {
+    BlockNot::cTime timeValue;
+    switch(units) {
+        case MINUTES:
+            timeValue.minutes = amount;
+            break;
+        case SECONDS:
+            timeValue.setSeconds(amount);
+            break;
+        case MILLISECONDS:
+            timeValue.millis = amount;
+            break;
+        case MICROSECONDS:
+            timeValue.micros = amount;
+            break;
+        case CYCLES:
+            timeValue.cycles = amount;
+            break;
+    }
+    return timeValue.getSeconds();
+}
+
+static unsigned long bucketTicks(const unsigned long window, const BlockNotUnit units) {
+    const double ticks = secondsOf(window, units) / secondsOf(1, BlockNot::getTickUnits(units));
+    const unsigned long bucket = static_cast<unsigned long>(ticks / BLOCKNOT_RATE_BUCKETS + 0.5);
+    return bucket > 0 ? bucket : 1;
+}
+
+static uint16_t tagEra(const unsigned long length) {
+    /*
+     * Bucket numbers start over every era so they fit in the 8 bit tag. An era is a whole
+     * number of rings, so a bucket always lands in the same slot, it is at least two rings so
+     * a tag from the bucket after the newest one can't be mistaken for one in the window, and
+     * it is kept well inside the 32 bit clock so the origin can trail behind by an era.
+     */
+    const unsigned long fits = 0x40000000UL / length;
+    const unsigned long buckets = (fits < 256) ? fits : 256;
+    return (buckets >= 2 * SLOTS) ? buckets / SLOTS * SLOTS : 2 * SLOTS;
+}
+
+static uint32_t addTagged(const uint32_t word, const uint32_t tag, const unsigned long events) {
+    // A count left in the slot by an older bucket is a whole ring old and out of the window, so it is replaced
+    const uint32_t count = ((word >> 24) == tag) ? (word & COUNT_MASK) : 0;
+    const uint32_t sum = (events >= COUNT_MASK - count) ? COUNT_MASK : static_cast<uint32_t>(count + events);
+    return (tag << 24) | sum;
+}
+
+/**
+ * Constructors
+ */
+
+BlockNotRateMeter::BlockNotRateMeter(const unsigned long window, const BlockNotUnit units) :
+        bucketTimer(UNLISTED, bucketTicks(window, units), BlockNot::getTickUnits(units)), windowTime(window),
+        counts(), total(0), newest(0), bucketStart(0), era(tagEra(bucketTimer.getRawDuration())),
+        origin(0), pending() {
+}
+
+/**
+ * Public Methods
+ */
+
+void BlockNotRateMeter::record(const unsigned long events) {
+    /*
+     * Only the pending slot for the current bucket is touched here, so this is safe to call
+     * from an interrupt. The event is tagged with its bucket number so a read that comes
+     * along much later still puts it in the bucket it happened in.
+     */
+#ifdef BLOCKNOT_RATE_ATOMIC
+    const uint32_t tag = tagAt(origin.load(std::memory_order_relaxed));
+    std::atomic<uint32_t> &slot = pending[tag % SLOTS];
+    uint32_t word = slot.load(std::memory_order_relaxed);
+    while (!slot.compare_exchange_weak(word, addTagged(word, tag, events), std::memory_order_relaxed)) {}
+#else
+    BlockNotCritical critical;
+    const uint32_t tag = tagAt(origin);
+    pending[tag % SLOTS] = addTagged(pending[tag % SLOTS], tag, events);
+#endif
+}
+
+double BlockNotRateMeter::getRate(const BlockNotUnit per) {
+    const double count = advance();
+    const double windowSeconds = secondsOf(static_cast<double>(bucketTimer.getRawDuration()) * BLOCKNOT_RATE_BUCKETS, bucketTimer.getBaseUnits());
+    return count / windowSeconds * secondsOf(1, per);
+}
+
+unsigned long BlockNotRateMeter::getCount() {
+    return static_cast<unsigned long>(advance() + 0.5);
+}
+
+unsigned long BlockNotRateMeter::getWindow() const {
+    return windowTime;
+}
+
+void BlockNotRateMeter::clear() {
+    for (uint8_t i = 0; i < SLOTS; i++) {
+        takePending(i);
+        counts[i] = 0;
+    }
+    total = 0;
+}
+
+/**
+ * Private Methods
+ */
+
+double BlockNotRateMeter::advance() {
+    /*
+     * There is one more bucket than the window holds. The newest one is still filling, so
+     * the window ends partway into the oldest one, and the oldest bucket only counts for the
+     * part of it that is still inside the window. That keeps the rate from jumping each time
+     * a bucket drops off.
+     *
+     * Events wait in the pending slots with the number of the bucket they were recorded in,
+     * and each read moves the ring along and then empties the slots of the buckets that went
+     * by since the last read, from the one that was newest then up to the newest now, into
+     * the bucket each tag says, dropping the ones that are out of the window by now. No other
+     * slot can have anything in it, so a meter that is read every bucket or so only looks at
+     * one or two slots. A meter that is only read now and then still has every event in the
+     * right bucket, as long as it is read at least once an era. An event recorded while this
+     * read is running can be tagged with the next bucket, and it waits for the next read,
+     * which starts from this bucket. The timer is never reset, it only
+     * supplies the time, and every position is kept as a 32 bit difference from it so
+     * rollover is handled the same way the timers handle it.
+     */
+    const unsigned long length = bucketTimer.getRawDuration();
+    const unsigned long elapsed = static_cast<uint32_t>(bucketTimer.getRawElapsed() - bucketStart);
+    const unsigned long passed = elapsed / length;
+    if (passed >= SLOTS) {
+        for (uint8_t i = 0; i < SLOTS; i++)
+            counts[i] = 0;
+        total = 0;
+    }
+    else {
+        for (unsigned long i = 0; i < passed; i++) {
+            newest = (newest + 1) % SLOTS;
+            total -= counts[newest];
+            counts[newest] = 0;
+        }
+    }
+    bucketStart = static_cast<uint32_t>(bucketStart + passed * length);
+    moveOrigin();
+#ifdef BLOCKNOT_RATE_ATOMIC
+    const uint32_t start = origin.load(std::memory_order_relaxed);
+#else
+    const uint32_t start = origin;
+#endif
+    const uint32_t newestTag = (static_cast<uint32_t>(bucketStart - start) / length) % era;
+    const unsigned long slots = (passed < SLOTS) ? passed + 1 : SLOTS;
+    for (unsigned long i = 0; i < slots; i++) {
+        const uint32_t word = takePending((newestTag + era - i) % SLOTS);
+        const uint32_t count = word & COUNT_MASK;
+        uint32_t age = (newestTag + era - (word >> 24)) % era;
+        if (age == era - 1u)
+            age = 0;
+        if (count == 0 || age >= SLOTS)
+            continue;
+        counts[(newest + SLOTS - age) % SLOTS] += count;
+        total += count;
+    }
+    const uint8_t oldest = (newest + 1) % SLOTS;
+    return total - counts[oldest] * (static_cast<double>(elapsed - passed * length) / length);
+}
+
+void BlockNotRateMeter::moveOrigin() {
+    /*
+     * Tags are counted from the origin, which trails the newest bucket by one to two eras.
+     * It only ever moves by whole eras, so a record() that still has the old origin comes up
+     * with the same tag, and one that read the clock a moment before this read still lands
+     * after the origin.
+     */
+    const uint64_t eraTicks = static_cast<uint64_t>(era) * bucketTimer.getRawDuration();
+#ifdef BLOCKNOT_RATE_ATOMIC
+    const uint32_t start = origin.load(std::memory_order_relaxed);
+#else
+    const uint32_t start = origin;
+#endif
+    const uint32_t behind = static_cast<uint32_t>(bucketStart - start);
+    if (behind < 2 * eraTicks)
+        return;
+    const uint32_t moved = static_cast<uint32_t>(start + (behind / eraTicks - 1) * eraTicks);
+#ifdef BLOCKNOT_RATE_ATOMIC
+    origin.store(moved, std::memory_order_relaxed);
+#else
+    BlockNotCritical critical;
+    origin = moved;
+#endif
+}
+
+uint32_t BlockNotRateMeter::tagAt(const uint32_t from) const {
+    return (static_cast<uint32_t>(bucketTimer.getRawElapsed() - from) / bucketTimer.getRawDuration()) % era;
+}
+
+uint32_t BlockNotRateMeter::takePending(const uint8_t slot) {
+#ifdef BLOCKNOT_RATE_ATOMIC
+    return pending[slot].exchange(0, std::memory_order_relaxed);
+#else
+    BlockNotCritical critical;
+    const uint32_t word = pending[slot];
+    pending[slot] = 0;
+    return word;
+#endif
+}
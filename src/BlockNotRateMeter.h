@@ -0,0 +1,75 @@
+/**
+ * BlockNotRateMeter measures how often something happens - pulses from a flow meter, turns
+ * of a shaft, packets on a wire - over a window that slides along with time instead of
+ * jumping from one window to the next. The window is split into buckets that are moved
+ * along only when the meter is read, and events can be recorded from an interrupt.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotRateMeter_h
+#define BlockNotRateMeter_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<atomic>)
+#define BLOCKNOT_RATE_ATOMIC
+#include <atomic>
+#endif
+#endif
+
+/**
+ * Bucket count - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_RATE_BUCKETS
+#define BLOCKNOT_RATE_BUCKETS   8
+#endif
+
+class BlockNotRateMeter {
+public:
+    explicit BlockNotRateMeter(unsigned long window, BlockNotUnit units = MILLISECONDS);
+
+    void record(unsigned long events = 1);
+
+    double getRate(BlockNotUnit per = SECONDS);
+
+    unsigned long getCount();
+
+    unsigned long getWindow() const;
+
+    void clear();
+
+private:
+    BlockNot bucketTimer;
+    unsigned long windowTime;
+    unsigned long counts[BLOCKNOT_RATE_BUCKETS + 1];
+    unsigned long total;
+    uint8_t newest;
+    unsigned long bucketStart;
+    uint16_t era;
+#ifdef BLOCKNOT_RATE_ATOMIC
+    std::atomic<uint32_t> origin;
+    std::atomic<uint32_t> pending[BLOCKNOT_RATE_BUCKETS + 1];
+#else
+    volatile uint32_t origin;
+    volatile uint32_t pending[BLOCKNOT_RATE_BUCKETS + 1];
+#endif
+
+    double advance();
+
+    void moveOrigin();
+
+    uint32_t tagAt(uint32_t from) const;
+
+    uint32_t takePending(uint8_t slot);
+};
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * BlockNotShard gives each CPU core its own set of timers and its own queue of
+ * ready handlers, so that timers can be polled and handled on every core at once.
+ * A core that runs out of work steals ready handlers from the other cores.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotShard.h>
+
+#ifdef BLOCKNOT_SHARDS
+
+/**
+ * BlockNotShard
+ */
+
+BlockNotShard::BlockNotShard() : timerCount(0), head(0), size(0), handled(0), stolen(0), dropped(0) {
+    lock.clear();
+    for (uint8_t i = 0; i < BLOCKNOT_SHARD_TIMERS; i++)
+        busy[i].store(false, std::memory_order_relaxed);
+}
+
+bool BlockNotShard::add(BlockNot &timer, const BlockNotHandler handler) {
+    /*
+     * The timer leaves the global reset list, so RESET_TIMERS and the other calls that walk
+     * every timer can't reach it from another core while its shard is polling it. A timer
+     * in the timer table can't leave, so it can't be added.
+     */
+    if (timerCount >= BLOCKNOT_SHARD_TIMERS || handler == nullptr) return false;
+    if (!timer.removeFromTimerList()) return false;
+    timers[timerCount] = &timer;
+    handlers[timerCount] = handler;
+    timerCount++;
+    return true;
+}
+
+uint8_t BlockNotShard::poll() {
+    /*
+     * Only the core that owns this shard ever calls poll(), so TRIGGERED (which resets
+     * the timer) is never called on the same timer from two cores. A timer whose handler
+     * is still queued or running - maybe on another core - is not checked at all until
+     * the handler is done, so one timer's handler never runs twice at the same time and
+     * nobody touches the timer while its handler has it. The trigger isn't lost, it is
+     * picked up on the first poll after the handler returns.
+     */
+    uint8_t ready = 0;
+    for (uint8_t i = 0; i < timerCount; i++) {
+        if (busy[i].load(std::memory_order_acquire)) continue;
+        if (timers[i]->triggered()) {
+            const Work work = {timers[i], handlers[i], i};
+            busy[i].store(true, std::memory_order_relaxed);
+            if (push(work))
+                ready++;
+            else {
+                busy[i].store(false, std::memory_order_relaxed);
+                dropped++;
+            }
+        }
+    }
+    return ready;
+}
+
+bool BlockNotShard::runOwn() {
+    Work work;
+    if (!popNewest(work)) return false;
+    run(work);
+    handled++;
+    return true;
+}
+
+bool BlockNotShard::runStolen(BlockNotShard &victim) {
+    Work work;
+    if (!victim.popOldest(work)) return false;
+    victim.run(work);
+    handled++;
+    stolen++;
+    return true;
+}
+
+uint8_t BlockNotShard::getTimerCount() const {
+    return timerCount;
+}
+
+unsigned long BlockNotShard::getHandled() const {
+    return handled;
+}
+
+unsigned long BlockNotShard::getStolen() const {
+    return stolen;
+}
+
+unsigned long BlockNotShard::getDropped() const {
+    return dropped;
+}
+
+void BlockNotShard::resetCounters() {
+    handled = 0;
+    stolen = 0;
+    dropped = 0;
+}
+
+/**
+ * The ready queue is a small ring buffer. The owner pushes and pops at the newest
+ * end, where the work is still warm in its cache, and thieves take from the oldest
+ * end. A spin lock around each operation keeps it safe between cores - the critical
+ * sections are only a few instructions long. size is only changed under the lock, it
+ * is atomic so that thieves can peek at it without taking the lock.
+ */
+
+bool BlockNotShard::push(const Work &work) {
+    acquire();
+    const bool room = size < BLOCKNOT_SHARD_QUEUE;
+    if (room) {
+        queue[(head + size) % BLOCKNOT_SHARD_QUEUE] = work;
+        size++;
+    }
+    release();
+    return room;
+}
+
+bool BlockNotShard::popNewest(Work &work) {
+    acquire();
+    const bool found = size > 0;
+    if (found) {
+        size--;
+        work = queue[(head + size) % BLOCKNOT_SHARD_QUEUE];
+    }
+    release();
+    return found;
+}
+
+bool BlockNotShard::popOldest(Work &work) {
+    // Thieves look before they lock, so idle cores do not hammer a busy core's lock
+    if (size.load(std::memory_order_relaxed) == 0) return false;
+    acquire();
+    const bool found = size > 0;
+    if (found) {
+        work = queue[head];
+        head = (head + 1) % BLOCKNOT_SHARD_QUEUE;
+        size--;
+    }
+    release();
+    return found;
+}
+
+void BlockNotShard::run(const Work &work) {
+    // Called on the shard that owns the timer, whichever core is running the handler
+    work.handler(*work.timer);
+    busy[work.slot].store(false, std::memory_order_release);
+}
+
+void BlockNotShard::acquire() {
+    while (lock.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+void BlockNotShard::release() {
+    lock.clear(std::memory_order_release);
+}
+
+/**
+ * BlockNotShards
+ */
+
+BlockNotShards::BlockNotShards(const uint8_t cores) : cores(cores > BLOCKNOT_MAX_SHARDS ? BLOCKNOT_MAX_SHARDS : cores == 0 ? 1 : cores) {
+}
+
+BlockNotShard &BlockNotShards::shard(const uint8_t core) {
+    // Always hands back a shard, so a core number out of range wraps around
+    return shards[core % cores];
+}
+
+uint8_t BlockNotShards::getCores() const {
+    return cores;
+}
+
+bool BlockNotShards::add(const uint8_t core, BlockNot &timer, const BlockNotHandler handler) {
+    return core < cores && shards[core].add(timer, handler);
+}
+
+unsigned long BlockNotShards::dispatch(const uint8_t core) {
+    /*
+     * Poll our own timers, drain our own queue, then go looking for work on the other
+     * cores - starting with the next core over so that thieves spread out instead of
+     * all piling onto core 0.
+     */
+    if (core >= cores) return 0;
+    BlockNotShard &own = shards[core];
+    unsigned long ran = 0;
+    own.poll();
+    while (own.runOwn()) ran++;
+    for (uint8_t i = 1; i < cores; i++) {
+        BlockNotShard &victim = shards[(core + i) % cores];
+        while (own.runStolen(victim)) {
+            ran++;
+            while (own.runOwn()) ran++;
+        }
+    }
+    return ran;
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * BlockNotShard gives each CPU core its own set of timers and its own queue of
+ * ready handlers, so that timers can be polled and handled on every core at once.
+ * A core that runs out of work steals ready handlers from the other cores.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotShard_h
+#define BlockNotShard_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<atomic>)
+#define BLOCKNOT_SHARDS
+#endif
+#endif
+
+#ifdef BLOCKNOT_SHARDS
+
+#include <atomic>
+
+/**
+ * Shard sizes - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_MAX_SHARDS
+#define BLOCKNOT_MAX_SHARDS         4
+#endif
+
+#ifndef BLOCKNOT_SHARD_TIMERS
+#define BLOCKNOT_SHARD_TIMERS       16
+#endif
+
+#ifndef BLOCKNOT_SHARD_QUEUE
+#define BLOCKNOT_SHARD_QUEUE        32
+#endif
+
+class BlockNotShard {
+public:
+    BlockNotShard();
+
+    bool add(BlockNot &timer, BlockNotHandler handler);
+
+    uint8_t poll();
+
+    bool runOwn();
+
+    bool runStolen(BlockNotShard &victim);
+
+    uint8_t getTimerCount() const;
+
+    unsigned long getHandled() const;
+
+    unsigned long getStolen() const;
+
+    unsigned long getDropped() const;
+
+    void resetCounters();
+
+private:
+    struct Work {
+        BlockNot *timer;
+        BlockNotHandler handler;
+        uint8_t slot;
+    };
+
+    BlockNot *timers[BLOCKNOT_SHARD_TIMERS];
+    BlockNotHandler handlers[BLOCKNOT_SHARD_TIMERS];
+    std::atomic<bool> busy[BLOCKNOT_SHARD_TIMERS];
+    uint8_t timerCount;
+
+    Work queue[BLOCKNOT_SHARD_QUEUE];
+    uint8_t head;
+    std::atomic<uint8_t> size;
+    std::atomic_flag lock;
+
+    unsigned long handled;
+    unsigned long stolen;
+    unsigned long dropped;
+
+    bool push(const Work &work);
+
+    bool popNewest(Work &work);
+
+    bool popOldest(Work &work);
+
+    void run(const Work &work);
+
+    void acquire();
+
+    void release();
+};
+
+/**
+ * A group of shards, one per core. Each core calls dispatch() with its own core
+ * number and only ever touches the timers that were added to its own shard.
+ */
+class BlockNotShards {
+public:
+    explicit BlockNotShards(uint8_t cores);
+
+    BlockNotShard &shard(uint8_t core);
+
+    uint8_t getCores() const;
+
+    bool add(uint8_t core, BlockNot &timer, BlockNotHandler handler);
+
+    unsigned long dispatch(uint8_t core);
+
+private:
+    BlockNotShard shards[BLOCKNOT_MAX_SHARDS];
+    uint8_t cores;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * BlockNotSimulator drives every BlockNot timer from a virtual clock instead of
+ * millis() and micros(), and jumps that clock straight to the next trigger so that
+ * days of timer behavior can be run in a fraction of a second.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotSimulator.h>
+
+#define NO_TRIGGER 0xFFFFFFFFFFFFFFFFULL
+
+/**
+ * Global Variables
+ */
+
+uint64_t BlockNotSimulator::nowMicros = 0;
+unsigned long BlockNotSimulator::wakeups = 0;
+bool BlockNotSimulator::active = false;
+
+/**
+ * Public Methods
+ */
+
+void BlockNotSimulator::begin(const uint64_t startMicros) {
+    nowMicros = startMicros;
+    wakeups = 0;
+    active = true;
+    BlockNot::setClock(virtualMillis, virtualMicros);
+}
+
+void BlockNotSimulator::end() {
+    active = false;
+    BlockNot::setClock();
+}
+
+bool BlockNotSimulator::isActive() {
+    return active;
+}
+
+uint64_t BlockNotSimulator::now() {
+    return nowMicros;
+}
+
+unsigned long BlockNotSimulator::virtualMillis() {
+    return static_cast<uint32_t>(nowMicros / SIM_MICROS_PER_MILLI);
+}
+
+unsigned long BlockNotSimulator::virtualMicros() {
+    return static_cast<uint32_t>(nowMicros);
+}
+
+void BlockNotSimulator::advance(const uint64_t micros) {
+    nowMicros += micros;
+}
+
+bool BlockNotSimulator::advanceToNextTrigger(const uint64_t limit) {
+    const uint64_t next = nextTriggerTime();
+    if (next == NO_TRIGGER || next > limit) {
+        nowMicros = limit;
+        return false;
+    }
+    nowMicros = next;
+    wakeups++;
+    return true;
+}
+
+unsigned long BlockNotSimulator::run(const uint64_t durationMicros, void (*loopFunction)()) {
+    const uint64_t endTime = nowMicros + durationMicros;
+    const unsigned long startWakeups = wakeups;
+    while (advanceToNextTrigger(endTime)) {
+        loopFunction();
+    }
+    return wakeups - startWakeups;
+}
+
+unsigned long BlockNotSimulator::getWakeups() {
+    return wakeups;
+}
+
+void BlockNotSimulator::resetWakeups() {
+    wakeups = 0;
+}
+
+/**
+ * Private Methods
+ */
+
+uint64_t BlockNotSimulator::nextTriggerTime() {
+    /*
+     * Timers that are already due were seen by the last loop pass and left alone
+     * (HAS_TRIGGERED, FIRST_TRIGGER etc.), so only timers with time remaining can
+     * move the clock forward. Millisecond timers trigger when millis() ticks over,
+     * which is on a whole millisecond boundary of the virtual clock. When coalescing
+     * is on, each timer may wait until the end of its slack window, the same way
+     * BlockNot::getMicrosUntilNextWakeup() works. Pools, timeout sets and PWM are
+     * seen through their wakeup sources.
+     */
+    const bool withSlack = BlockNot::isCoalescing();
+    uint64_t next = NO_TRIGGER;
+    BlockNot::forEachDeadline([&next, withSlack](const BlockNotDeadline &deadline) {
+        if (!deadline.status.running) return;
+        const unsigned long remaining = deadline.status.remaining;
+        if (remaining == 0) return;
+        const unsigned long slack = withSlack ? deadline.slack : 0;
+        const unsigned long ticks = (remaining > 0xFFFFFFFFUL - slack) ? 0xFFFFFFFFUL : remaining + slack;
+        const BlockNotUnit units = deadline.units;
+        // Millisecond ticks are counted from the last whole millisecond
+        const uint64_t from = (units == MILLISECONDS) ? nowMicros / SIM_MICROS_PER_MILLI * SIM_MICROS_PER_MILLI : nowMicros;
+        const uint64_t due = from + BlockNot::ticksToMicros(ticks, units);
+        if (due < next) next = due;
+    });
+    return next;
+}
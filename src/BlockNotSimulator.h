@@ -0,0 +1,63 @@
+/**
+ * BlockNotSimulator drives every BlockNot timer from a virtual clock instead of
+ * millis() and micros(), and jumps that clock straight to the next trigger so that
+ * days of timer behavior can be run in a fraction of a second.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotSimulator_h
+#define BlockNotSimulator_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#define SIM_MICROS_PER_MILLI    1000ULL
+#define SIM_MICROS_PER_SECOND   1000000ULL
+#define SIM_MICROS_PER_MINUTE   60000000ULL
+#define SIM_MICROS_PER_HOUR     3600000000ULL
+#define SIM_MICROS_PER_DAY      86400000000ULL
+
+/**
+ * Virtual time is kept as a 64 bit count of microseconds. millis() and micros() are
+ * derived from it and truncated to 32 bits, so they roll over at exactly the same
+ * points they do on real hardware.
+ */
+class BlockNotSimulator {
+public:
+    static void begin(uint64_t startMicros = 0);
+
+    static void end();
+
+    static bool isActive();
+
+    static uint64_t now();
+
+    static unsigned long virtualMillis();
+
+    static unsigned long virtualMicros();
+
+    static void advance(uint64_t micros);
+
+    static bool advanceToNextTrigger(uint64_t limit);
+
+    static unsigned long run(uint64_t durationMicros, void (*loopFunction)());
+
+    static unsigned long getWakeups();
+
+    static void resetWakeups();
+
+private:
+    static uint64_t nowMicros;
+    static unsigned long wakeups;
+    static bool active;
+
+    static uint64_t nextTriggerTime();
+};
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * BlockNotTimeoutSet keeps a timeout for each of many outstanding requests, looked up by
+ * the request's id. Adding and cancelling a timeout is quick no matter how many there are,
+ * and checking for timeouts only ever looks at the ones that are actually due, so it
+ * scales to hundreds of requests where polling a timer for each one would not.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotTimeoutSet.h>
+
+#define TABLE_SIZE      (BLOCKNOT_TIMEOUTS * 2)
+#define EMPTY_SLOT      0
+#define MAX_TICKS       0x7FFFFFFFUL
+
+static_assert(BLOCKNOT_TIMEOUTS > 0 && BLOCKNOT_TIMEOUTS < 0x8000, "BLOCKNOT_TIMEOUTS must be between 1 and 32767");
+
+/*
+ * The timeouts are kept in a binary min-heap ordered by when they are due, so the next one
+ * to expire is always on top. A hash table with linear probing takes a key to its place in
+ * the heap, which is what makes cancel() quick. The table is twice the size of the heap so
+ * it never fills up, and each heap entry remembers its slot in the table so the two can be
+ * kept pointing at each other as entries move around.
+ */
+
+static uint16_t homeSlot(const uint32_t key) {
+    /*
+     * Fibonacci hashing mixes the key into the high bits of the product, and the low bits of
+     * sequential ids barely change, so the slot comes from the high bits. Scaling the product
+     * by the table size picks them without needing a power of two.
+     */
+    const uint32_t mixed = static_cast<uint32_t>(key * 2654435761UL);
+    return static_cast<uint16_t>((static_cast<uint64_t>(mixed) * TABLE_SIZE) >> 32);
+}
+
+/**
+ * Constructors
+ */
+
+BlockNotTimeoutSet::BlockNotTimeoutSet(const BlockNotUnit units) : clock(UNLISTED, 1, BlockNot::getTickUnits(units)), timeoutUnits(units), table(), count(0) {
+    BlockNot::addWakeupSource(visitDeadlines, this);
+}
+
+BlockNotTimeoutSet::~BlockNotTimeoutSet() {
+    BlockNot::removeWakeupSource(this);
+}
+
+/**
+ * Public Methods
+ */
+
+bool BlockNotTimeoutSet::add(const uint32_t key, const unsigned long timeout) {
+    // Adding a key that is already in the set starts its timeout over with the new time
+    const Entry entry = {key, now(), toTicks(timeout), 0};
+    const int32_t found = findSlot(key);
+    if (found >= 0) {
+        const uint16_t index = table[found] - 1;
+        heap[index].start = entry.start;
+        heap[index].duration = entry.duration;
+        settle(index);
+        return true;
+    }
+    if (count >= BLOCKNOT_TIMEOUTS) return false;
+    uint16_t slot = homeSlot(key);
+    while (table[slot] != EMPTY_SLOT)
+        slot = (slot + 1) % TABLE_SIZE;
+    Entry placed = entry;
+    placed.slot = slot;
+    place(count++, placed);
+    siftUp(count - 1);
+    return true;
+}
+
+bool BlockNotTimeoutSet::cancel(const uint32_t key) {
+    const int32_t slot = findSlot(key);
+    if (slot < 0) return false;
+    removeAt(table[slot] - 1);
+    return true;
+}
+
+bool BlockNotTimeoutSet::contains(const uint32_t key) const {
+    return findSlot(key) >= 0;
+}
+
+bool BlockNotTimeoutSet::expired(uint32_t &key) {
+    // Only the top of the heap is ever looked at - nothing else can be due before it is
+    if (count == 0) return false;
+    const Entry &next = heap[0];
+    if (static_cast<uint32_t>(now() - next.start) < next.duration) return false;
+    key = next.key;
+    removeAt(0);
+    return true;
+}
+
+unsigned long BlockNotTimeoutSet::getRawTimeUntilNext() const {
+    if (count == 0) return NO_TIMEOUT;
+    const unsigned long elapsed = static_cast<uint32_t>(now() - heap[0].start);
+    return elapsed >= heap[0].duration ? 0 : heap[0].duration - elapsed;
+}
+
+uint16_t BlockNotTimeoutSet::getCount() const {
+    return count;
+}
+
+uint16_t BlockNotTimeoutSet::getCapacity() const {
+    return BLOCKNOT_TIMEOUTS;
+}
+
+void BlockNotTimeoutSet::clear() {
+    for (uint16_t i = 0; i < TABLE_SIZE; i++)
+        table[i] = EMPTY_SLOT;
+    count = 0;
+}
+
+/**
+ * Private Methods
+ */
+
+unsigned long BlockNotTimeoutSet::now() const {
+    // The clock timer is never reset, so its elapsed time is a 32 bit tick count like millis()
+    return clock.getRawElapsed();
+}
+
+unsigned long BlockNotTimeoutSet::toTicks(const unsigned long timeout) const {
+    /*
+     * The heap orders timeouts by the signed difference of when they are due, the same way
+     * millis() rollover is usually handled, so a single timeout can be at most half of the
+     * 32 bit range - almost 25 days for millisecond ticks.
+     */
+    unsigned long multiplier = 1;
+    if (timeoutUnits == SECONDS) multiplier = 1000UL;
+    if (timeoutUnits == MINUTES) multiplier = 60000UL;
+    return (timeout > MAX_TICKS / multiplier) ? MAX_TICKS : timeout * multiplier;
+}
+
+int32_t BlockNotTimeoutSet::findSlot(const uint32_t key) const {
+    for (uint16_t slot = homeSlot(key); table[slot] != EMPTY_SLOT; slot = (slot + 1) % TABLE_SIZE) {
+        if (heap[table[slot] - 1].key == key) return slot;
+    }
+    return -1;
+}
+
+void BlockNotTimeoutSet::removeAt(const uint16_t index) {
+    removeSlot(heap[index].slot);
+    count--;
+    if (index == count) return;
+    place(index, heap[count]);
+    settle(index);
+}
+
+void BlockNotTimeoutSet::removeSlot(const uint16_t slot) {
+    /*
+     * Linear probing can't just empty a slot, or keys further along the same run would no
+     * longer be found. Instead, every key after the hole that would still be reachable from
+     * its home slot with the hole filled is moved back into it, until the run ends.
+     */
+    uint16_t hole = slot;
+    table[hole] = EMPTY_SLOT;
+    for (uint16_t next = (hole + 1) % TABLE_SIZE; table[next] != EMPTY_SLOT; next = (next + 1) % TABLE_SIZE) {
+        const uint16_t home = homeSlot(heap[table[next] - 1].key);
+        const bool stays = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (stays) continue;
+        table[hole] = table[next];
+        heap[table[hole] - 1].slot = hole;
+        table[next] = EMPTY_SLOT;
+        hole = next;
+    }
+}
+
+void BlockNotTimeoutSet::place(const uint16_t index, const Entry &entry) {
+    heap[index] = entry;
+    table[entry.slot] = index + 1;
+}
+
+bool BlockNotTimeoutSet::before(const Entry &a, const Entry &b) const {
+    return static_cast<int32_t>(static_cast<uint32_t>((a.start + a.duration) - (b.start + b.duration))) < 0;
+}
+
+void BlockNotTimeoutSet::settle(const uint16_t index) {
+    // An entry that changed can only need to go one way, up toward the top or down
+    if (index > 0 && before(heap[index], heap[(index - 1) / 2]))
+        siftUp(index);
+    else
+        siftDown(index);
+}
+
+void BlockNotTimeoutSet::siftUp(uint16_t index) {
+    const Entry entry = heap[index];
+    while (index > 0) {
+        const uint16_t parent = (index - 1) / 2;
+        if (!before(entry, heap[parent])) break;
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void BlockNotTimeoutSet::siftDown(uint16_t index) {
+    const Entry entry = heap[index];
+    while (true) {
+        uint16_t child = index * 2 + 1;
+        if (child >= count) break;
+        if (child + 1 < count && before(heap[child + 1], heap[child])) child++;
+        if (!before(heap[child], entry)) break;
+        place(index, heap[child]);
+        index = child;
+    }
+    place(index, entry);
+}
+
+void BlockNotTimeoutSet::visitDeadlines(const void *owner, const BlockNotDeadlineVisit visit, void *context) {
+    // Only the top of the heap can be the next one due, so it stands in for the whole set
+    const BlockNotTimeoutSet &set = *static_cast<const BlockNotTimeoutSet *>(owner);
+    if (set.count == 0) return;
+    BlockNotDeadline deadline = {};
+    deadline.status.running = true;
+    deadline.status.elapsed = static_cast<uint32_t>(set.now() - set.heap[0].start);
+    deadline.status.duration = set.heap[0].duration;
+    deadline.status.due = deadline.status.elapsed >= deadline.status.duration;
+    deadline.status.remaining = deadline.status.due ? 0 : deadline.status.duration - deadline.status.elapsed;
+    deadline.units = set.clock.getBaseUnits();
+    visit(deadline, context);
+}
@@ -0,0 +1,90 @@
+/**
+ * BlockNotTimeoutSet keeps a timeout for each of many outstanding requests, looked up by
+ * the request's id. Adding and cancelling a timeout is quick no matter how many there are,
+ * and checking for timeouts only ever looks at the ones that are actually due, so it
+ * scales to hundreds of requests where polling a timer for each one would not.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotTimeoutSet_h
+#define BlockNotTimeoutSet_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+/**
+ * Set size - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_TIMEOUTS
+#define BLOCKNOT_TIMEOUTS       32
+#endif
+
+#define NO_TIMEOUT              0xFFFFFFFFUL
+
+class BlockNotTimeoutSet {
+public:
+    explicit BlockNotTimeoutSet(BlockNotUnit units = MILLISECONDS);
+
+    ~BlockNotTimeoutSet();
+
+    bool add(uint32_t key, unsigned long timeout);
+
+    bool cancel(uint32_t key);
+
+    bool contains(uint32_t key) const;
+
+    bool expired(uint32_t &key);
+
+    unsigned long getRawTimeUntilNext() const;
+
+    uint16_t getCount() const;
+
+    uint16_t getCapacity() const;
+
+    void clear();
+
+private:
+    struct Entry {
+        uint32_t key;
+        unsigned long start;
+        unsigned long duration;
+        uint16_t slot;
+    };
+
+    BlockNot clock;
+    BlockNotUnit timeoutUnits;
+    Entry heap[BLOCKNOT_TIMEOUTS];
+    uint16_t table[BLOCKNOT_TIMEOUTS * 2];
+    uint16_t count;
+
+    unsigned long now() const;
+
+    unsigned long toTicks(unsigned long timeout) const;
+
+    int32_t findSlot(uint32_t key) const;
+
+    void removeAt(uint16_t index);
+
+    void removeSlot(uint16_t slot);
+
+    void place(uint16_t index, const Entry &entry);
+
+    bool before(const Entry &a, const Entry &b) const;
+
+    void settle(uint16_t index);
+
+    void siftUp(uint16_t index);
+
+    void siftDown(uint16_t index);
+
+    static void visitDeadlines(const void *owner, BlockNotDeadlineVisit visit, void *context);
+};
+
+#endif
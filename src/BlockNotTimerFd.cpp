@@ -0,0 +1,145 @@
+/**
+ * BlockNotTimerFd puts the earliest BlockNot trigger onto a Linux timerfd, so a
+ * process can block in epoll() or poll() until either a timer or one of its other
+ * file descriptors needs attention, instead of spinning on TRIGGERED.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotTimerFd.h>
+
+#if defined(__linux__)
+
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <unistd.h>
+
+/**
+ * Constructors
+ */
+
+BlockNotTimerFd::BlockNotTimerFd() : fd(NO_TIMER_FD), millisClock(UNLISTED, 1), microsClock(UNLISTED, 1, MICROSECONDS),
+        lastArmMillis(0), lastArmMicros(0), armedBefore(false) {
+}
+
+BlockNotTimerFd::~BlockNotTimerFd() {
+    end();
+}
+
+/**
+ * Public Methods
+ */
+
+bool BlockNotTimerFd::begin() {
+    if (fd == NO_TIMER_FD)
+        fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    return fd != NO_TIMER_FD;
+}
+
+void BlockNotTimerFd::end() {
+    if (fd != NO_TIMER_FD) {
+        close(fd);
+        fd = NO_TIMER_FD;
+    }
+}
+
+int BlockNotTimerFd::getFd() const {
+    return fd;
+}
+
+bool BlockNotTimerFd::addToEpoll(const int epollFd) const {
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return fd != NO_TIMER_FD && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+bool BlockNotTimerFd::arm() {
+    const unsigned long next = nextWakeup();
+    return next == 0xFFFFFFFFUL ? disarm() : arm(next);
+}
+
+bool BlockNotTimerFd::arm(const unsigned long microseconds) {
+    /*
+     * An all zero it_value disarms a timerfd, so a timer that is already due is
+     * armed for one nanosecond, which makes the fd readable straight away.
+     */
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(microseconds / 1000000UL);
+    spec.it_value.tv_nsec = static_cast<long>((microseconds % 1000000UL) * 1000UL);
+    if (microseconds == 0) spec.it_value.tv_nsec = 1;
+    return fd != NO_TIMER_FD && timerfd_settime(fd, 0, &spec, nullptr) == 0;
+}
+
+bool BlockNotTimerFd::disarm() {
+    const itimerspec spec = {};
+    return fd != NO_TIMER_FD && timerfd_settime(fd, 0, &spec, nullptr) == 0;
+}
+
+unsigned long BlockNotTimerFd::acknowledge() {
+    uint64_t expirations = 0;
+    if (fd == NO_TIMER_FD || read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return 0;
+    return static_cast<unsigned long>(expirations);
+}
+
+bool BlockNotTimerFd::wait(const int timeoutMillis) {
+    if (!arm()) return false;
+    pollfd target = {};
+    target.fd = fd;
+    target.events = POLLIN;
+    const bool expired = poll(&target, 1, timeoutMillis) > 0;
+    acknowledge();
+    return expired;
+}
+
+/**
+ * Private Methods
+ */
+
+unsigned long BlockNotTimerFd::nextWakeup() {
+    /*
+     * Same as BlockNot::getMicrosUntilNextWakeup(), except for timers that are left due on
+     * purpose - a stopwatch read with ELAPSED, or a timer checked with HAS_TRIGGERED or
+     * FIRST_TRIGGER. Whether a timer is due only depends on the tick count of its clock, so
+     * a timer that was already due at the tick of the last arm() has been through a whole
+     * loop pass since then, and it is left out the same way BlockNotSimulator leaves it out.
+     * A timer that came due after that tick, even right after the loop checked it, still
+     * wakes the loop straight away. CYCLES timers are measured against micros(), which is
+     * close enough since nothing can come due, be checked and be armed again in under a
+     * microsecond. The deadlines of pools, timeout sets and PWM go through the same check.
+     */
+    const unsigned long nowMillis = millisClock.getRawElapsed();
+    const unsigned long nowMicros = microsClock.getRawElapsed();
+    const unsigned long sinceMillis = armedBefore ? static_cast<uint32_t>(nowMillis - lastArmMillis) : 0xFFFFFFFFUL;
+    const unsigned long sinceMicros = armedBefore ? static_cast<uint32_t>(nowMicros - lastArmMicros) : 0xFFFFFFFFUL;
+    const bool withSlack = BlockNot::isCoalescing();
+    lastArmMillis = nowMillis;
+    lastArmMicros = nowMicros;
+    armedBefore = true;
+    unsigned long next = 0xFFFFFFFFUL;
+    BlockNot::forEachDeadline([&next, sinceMillis, sinceMicros, withSlack](const BlockNotDeadline &deadline) {
+        const BlockNotStatus &status = deadline.status;
+        if (!status.running) return;
+        const BlockNotUnit units = deadline.units;
+        unsigned long sinceArm = (units == MICROSECONDS || units == CYCLES) ? sinceMicros : sinceMillis;
+        if (units == CYCLES && sinceArm != 0xFFFFFFFFUL)
+            sinceArm = static_cast<unsigned long>(static_cast<uint64_t>(sinceArm) * BlockNot::getCycleFrequency() / 1000000ULL);
+        // A timer told to TRIGGER_NEXT is due without being overdue, and always wakes the loop
+        if (status.due && status.elapsed >= status.duration && status.elapsed - status.duration >= sinceArm) return;
+        unsigned long ticks = status.remaining;
+        if (withSlack)
+            ticks = (ticks > 0xFFFFFFFFUL - deadline.slack) ? 0xFFFFFFFFUL : ticks + deadline.slack;
+        const uint64_t wait = BlockNot::ticksToMicros(ticks, units);
+        if (wait < next) next = static_cast<unsigned long>(wait);
+    });
+    return next;
+}
+
+#endif
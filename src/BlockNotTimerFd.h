@@ -0,0 +1,65 @@
+/**
+ * BlockNotTimerFd puts the earliest BlockNot trigger onto a Linux timerfd, so a
+ * process can block in epoll() or poll() until either a timer or one of its other
+ * file descriptors needs attention, instead of spinning on TRIGGERED.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotTimerFd_h
+#define BlockNotTimerFd_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#if defined(__linux__)
+
+#define NO_TIMER_FD -1
+
+class BlockNotTimerFd {
+public:
+    BlockNotTimerFd();
+
+    ~BlockNotTimerFd();
+
+    bool begin();
+
+    void end();
+
+    int getFd() const;
+
+    bool addToEpoll(int epollFd) const;
+
+    bool arm();
+
+    bool arm(unsigned long microseconds);
+
+    bool disarm();
+
+    unsigned long acknowledge();
+
+    bool wait(int timeoutMillis = -1);
+
+private:
+    int fd;
+    BlockNot millisClock;
+    BlockNot microsClock;
+    unsigned long lastArmMillis;
+    unsigned long lastArmMicros;
+    bool armedBefore;
+
+    unsigned long nextWakeup();
+
+    BlockNotTimerFd(const BlockNotTimerFd &);
+
+    BlockNotTimerFd &operator=(const BlockNotTimerFd &);
+};
+
+#endif
+
+#endif
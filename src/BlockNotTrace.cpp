@@ -0,0 +1,365 @@
+/**
+ * BlockNotTrace records every trigger, reset, start and stop of your timers into a
+ * small ring buffer, so that you can see when each timer actually fired - and how
+ * late it was - after the fact. The capture can be written out as Chrome trace JSON
+ * (Perfetto, chrome://tracing) or as a VCD file (GTKWave, PulseView) to line it up
+ * with logic analyzer captures.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+
+#include <BlockNotTrace.h>
+
+static_assert((BLOCKNOT_TRACE_EVENTS & (BLOCKNOT_TRACE_EVENTS - 1)) == 0, "BLOCKNOT_TRACE_EVENTS must be a power of two");
+static_assert(BLOCKNOT_TRACE_TIMERS < 93, "BLOCKNOT_TRACE_TIMERS must be less than 93");
+
+/**
+ * Global Variables
+ */
+
+BlockNotTrace::Slot BlockNotTrace::slots[BLOCKNOT_TRACE_EVENTS];
+const BlockNot *BlockNotTrace::timers[BLOCKNOT_TRACE_TIMERS] = {};
+const char *BlockNotTrace::labels[BLOCKNOT_TRACE_TIMERS] = {};
+#ifdef BLOCKNOT_TRACE_ATOMIC
+std::atomic<uint32_t> BlockNotTrace::written(0);
+#else
+volatile uint32_t BlockNotTrace::written = 0;
+#endif
+bool BlockNotTrace::active = false;
+
+static const char *const eventNames[] = {"trigger", "reset", "start", "stop"};
+
+static void hook(const BlockNot &timer, const BlockNotEvent event, const unsigned long lateness) {
+    BlockNotTrace::record(timer, event, lateness);
+}
+
+static void printTime(Print &output, uint64_t value) {
+    // Not every core can print 64 bit numbers
+    char digits[21];
+    uint8_t index = sizeof(digits) - 1;
+    digits[index] = '\0';
+    do {
+        digits[--index] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    output.print(&digits[index]);
+}
+
+static void printCode(Print &output, const uint8_t wire, const uint8_t slot) {
+    // VCD identifiers are printable characters - the first names the signal, the second the timer
+    output.print(static_cast<char>('!' + wire));
+    output.print(static_cast<char>('!' + slot));
+}
+
+static void printStep(Print &output, const uint64_t time) {
+    output.print("#");
+    printTime(output, time);
+    output.print("\n");
+}
+
+static void writeFalls(Print &output, bool (&falling)[BLOCKNOT_TRACE_TIMERS + 1][2]) {
+    for (uint8_t slot = 0; slot <= BLOCKNOT_TRACE_TIMERS; slot++) {
+        for (uint8_t wire = 0; wire < 2; wire++) {
+            if (!falling[slot][wire]) continue;
+            falling[slot][wire] = false;
+            output.print("0");
+            printCode(output, wire, slot);
+            output.print("\n");
+        }
+    }
+}
+
+/**
+ * Public Methods
+ */
+
+void BlockNotTrace::begin() {
+    // Every timer gets its id now, so record() never has to change the table
+    BlockNot::forEachTimer([](const BlockNot &timer) {
+        assign(timer);
+    });
+    active = true;
+    BlockNot::setTraceHook(hook);
+}
+
+void BlockNotTrace::end() {
+    BlockNot::setTraceHook();
+    active = false;
+}
+
+bool BlockNotTrace::isActive() {
+    return active;
+}
+
+void BlockNotTrace::clear() {
+    for (Slot &slot : slots)
+        slot.sequence = 0;
+    written = 0;
+}
+
+uint8_t BlockNotTrace::name(const BlockNot &timer, const char *label) {
+    const uint8_t id = assign(timer);
+    if (id != TRACE_OTHER_TIMER) labels[id] = label;
+    return id;
+}
+
+uint8_t BlockNotTrace::getTimerId(const BlockNot &timer) {
+    // Only looks - ids are handed out by name() and begin(), so this is safe from any core
+    for (uint8_t id = 0; id < BLOCKNOT_TRACE_TIMERS && timers[id] != nullptr; id++) {
+        if (timers[id] == &timer) return id;
+    }
+    return TRACE_OTHER_TIMER;
+}
+
+void BlockNotTrace::record(const BlockNot &timer, const BlockNotEvent event, const unsigned long lateness) {
+    if (!active) return;
+    const uint64_t late = BlockNot::ticksToMicros(lateness, timer.getBaseUnits());
+    const uint32_t micros = (late > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : static_cast<uint32_t>(late);
+    const uint32_t number = claim();
+    Slot &slot = slots[number & (BLOCKNOT_TRACE_EVENTS - 1)];
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+#else
+    {
+        BlockNotCritical critical;
+        slot.sequence = 0;
+    }
+#endif
+    // The hardware clock, so the trace lines up with a logic analyzer even with a clock correction set
+    slot.event.time = BlockNot::getRawMicros();
+    slot.event.lateness = micros;
+    slot.event.timer = getTimerId(timer);
+    slot.event.event = static_cast<uint8_t>(event);
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    slot.sequence.store(number + 1, std::memory_order_release);
+#else
+    BlockNotCritical critical;
+    slot.sequence = number + 1;
+#endif
+}
+
+uint16_t BlockNotTrace::getCount() {
+    const uint32_t count = total();
+    return (count > BLOCKNOT_TRACE_EVENTS) ? BLOCKNOT_TRACE_EVENTS : static_cast<uint16_t>(count);
+}
+
+unsigned long BlockNotTrace::getOverwritten() {
+    const uint32_t count = total();
+    return (count > BLOCKNOT_TRACE_EVENTS) ? count - BLOCKNOT_TRACE_EVENTS : 0;
+}
+
+bool BlockNotTrace::getEvent(const uint16_t index, BlockNotTraceEvent &event) {
+    /*
+     * Oldest first. The event is only handed back if its slot holds the same, finished event
+     * before and after it was copied - one that is still being written, or that a writer
+     * lapped while it was being read, is reported as missing instead of coming back torn.
+     */
+    const uint32_t count = total();
+    const uint16_t held = (count > BLOCKNOT_TRACE_EVENTS) ? BLOCKNOT_TRACE_EVENTS : static_cast<uint16_t>(count);
+    if (index >= held) return false;
+    const uint32_t number = count - held + index;
+    const Slot &slot = slots[number & (BLOCKNOT_TRACE_EVENTS - 1)];
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+#else
+    BlockNotCritical critical;
+    const uint32_t before = slot.sequence;
+    event = slot.event;
+    const uint32_t after = slot.sequence;
+#endif
+    return before == number + 1 && after == number + 1;
+}
+
+void BlockNotTrace::writeChromeTrace(Print &output) {
+    /*
+     * Each timer shows up as its own thread, and every event is an instant event at its
+     * time in microseconds (counted from the first event), with the lateness as an argument.
+     */
+    output.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (uint8_t id = 0; id < timerCount(); id++) {
+        output.print(first ? "\n" : ",\n");
+        first = false;
+        output.print("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+        output.print(static_cast<unsigned int>(id));
+        output.print(",\"args\":{\"name\":\"");
+        printName(output, id);
+        output.print("\"}}");
+    }
+    const uint16_t count = getCount();
+    BlockNotTraceEvent event;
+    uint32_t previous = 0;
+    uint64_t time = 0;
+    bool started = false;
+    for (uint16_t index = 0; index < count; index++) {
+        if (!getEvent(index, event)) continue;
+        if (started) time += static_cast<uint32_t>(event.time - previous);
+        started = true;
+        previous = event.time;
+        output.print(first ? "\n" : ",\n");
+        first = false;
+        output.print("{\"name\":\"");
+        output.print(eventNames[event.event & 3]);
+        output.print("\",\"cat\":\"BlockNot\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":");
+        output.print(static_cast<unsigned int>(event.timer));
+        output.print(",\"ts\":");
+        printTime(output, time);
+        output.print(",\"args\":{\"lateness\":");
+        output.print(static_cast<unsigned long>(event.lateness));
+        output.print("}}");
+    }
+    output.print("\n]}\n");
+}
+
+void BlockNotTrace::writeVcd(Print &output) {
+    /*
+     * Each timer gets three signals: a one microsecond pulse for every trigger, another for
+     * every reset, and a level that goes high on start and low on stop. Time zero is the
+     * first event in the buffer.
+     */
+    const uint8_t named = timerCount();
+    const uint8_t other = BLOCKNOT_TRACE_TIMERS;
+    const uint16_t count = getCount();
+    BlockNotTraceEvent event;
+    bool hasOther = false;
+    for (uint16_t index = 0; index < count; index++) {
+        if (getEvent(index, event) && event.timer == TRACE_OTHER_TIMER) hasOther = true;
+    }
+    static const char *const signals[] = {"_trigger", "_reset", "_running"};
+    output.print("$timescale 1us $end\n$scope module blocknot $end\n");
+    for (uint8_t slot = 0; slot <= other; slot++) {
+        if (slot == named && !hasOther) break;
+        if (slot == named) slot = other;
+        for (uint8_t wire = 0; wire < 3; wire++) {
+            output.print("$var wire 1 ");
+            printCode(output, wire, slot);
+            output.print(" ");
+            printName(output, slot == other ? TRACE_OTHER_TIMER : slot);
+            output.print(signals[wire]);
+            output.print(" $end\n");
+        }
+    }
+    output.print("$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (uint8_t slot = 0; slot <= other; slot++) {
+        if (slot == named && !hasOther) break;
+        if (slot == named) slot = other;
+        for (uint8_t wire = 0; wire < 3; wire++) {
+            output.print(wire == 2 ? "x" : "0");
+            printCode(output, wire, slot);
+            output.print("\n");
+        }
+    }
+    output.print("$end\n");
+
+    bool falling[BLOCKNOT_TRACE_TIMERS + 1][2] = {};
+    bool pending = false;
+    uint32_t previous = 0;
+    uint64_t time = 0;
+    uint64_t last = 0;
+    bool started = false;
+    for (uint16_t index = 0; index < count; index++) {
+        if (!getEvent(index, event)) continue;
+        if (started) time += static_cast<uint32_t>(event.time - previous);
+        previous = event.time;
+        if (started && time != last) {
+            // Pulses end one microsecond after they start
+            if (pending && last + 1 < time) {
+                printStep(output, last + 1);
+                writeFalls(output, falling);
+            }
+            printStep(output, time);
+            if (pending) writeFalls(output, falling);
+            pending = false;
+        }
+        const uint8_t slot = (event.timer == TRACE_OTHER_TIMER) ? other : event.timer;
+        switch (event.event) {
+            case TRACE_TRIGGER:
+            case TRACE_RESET: {
+                const uint8_t wire = (event.event == TRACE_TRIGGER) ? 0 : 1;
+                output.print("1");
+                printCode(output, wire, slot);
+                output.print("\n");
+                falling[slot][wire] = true;
+                pending = true;
+                break;
+            }
+            default: {
+                output.print(event.event == TRACE_START ? "1" : "0");
+                printCode(output, 2, slot);
+                output.print("\n");
+                break;
+            }
+        }
+        last = time;
+        started = true;
+    }
+    if (pending) {
+        printStep(output, last + 1);
+        writeFalls(output, falling);
+    }
+}
+
+/**
+ * Private Methods
+ */
+
+uint32_t BlockNotTrace::claim() {
+    // Each writer gets its own slot, so events can be recorded from interrupts and other cores
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    return written.fetch_add(1, std::memory_order_relaxed);
+#else
+    BlockNotCritical critical;
+    const uint32_t slot = written;
+    written = slot + 1;
+    return slot;
+#endif
+}
+
+uint32_t BlockNotTrace::total() {
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    return written;
+#else
+    BlockNotCritical critical;
+    return written;
+#endif
+}
+
+uint8_t BlockNotTrace::assign(const BlockNot &timer) {
+    // When the table is full the rest share TRACE_OTHER_TIMER
+    for (uint8_t id = 0; id < BLOCKNOT_TRACE_TIMERS; id++) {
+        if (timers[id] == &timer) return id;
+        if (timers[id] == nullptr) {
+            timers[id] = &timer;
+            return id;
+        }
+    }
+    return TRACE_OTHER_TIMER;
+}
+
+uint8_t BlockNotTrace::timerCount() {
+    uint8_t count = 0;
+    while (count < BLOCKNOT_TRACE_TIMERS && timers[count] != nullptr) count++;
+    return count;
+}
+
+void BlockNotTrace::printName(Print &output, const uint8_t id) {
+    if (id == TRACE_OTHER_TIMER) {
+        output.print("other");
+        return;
+    }
+    if (labels[id] != nullptr) {
+        output.print(labels[id]);
+        return;
+    }
+    output.print("timer");
+    output.print(static_cast<unsigned int>(id));
+}
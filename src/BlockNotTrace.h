@@ -0,0 +1,114 @@
+/**
+ * BlockNotTrace records every trigger, reset, start and stop of your timers into a
+ * small ring buffer, so that you can see when each timer actually fired - and how
+ * late it was - after the fact. The capture can be written out as Chrome trace JSON
+ * (Perfetto, chrome://tracing) or as a VCD file (GTKWave, PulseView) to line it up
+ * with logic analyzer captures.
+ *
+ * Written by - Michael Sims
+ * Full documentation can be found at: https://github.com/EasyG0ing1/BlockNot
+ *
+ * See LICENSE file for acceptable use conditions - this is open source
+ * and there are no restrictions on its usage, I simply ask for some acknowledgment
+ * if it is used in your project.
+ */
+#ifndef BlockNotTrace_h
+#define BlockNotTrace_h
+
+#include <BlockNot.h>
+
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<atomic>)
+#define BLOCKNOT_TRACE_ATOMIC
+#include <atomic>
+#endif
+#endif
+
+/**
+ * Trace sizes - see Build Flags in README.md
+ */
+
+#ifndef BLOCKNOT_TRACE_EVENTS
+#define BLOCKNOT_TRACE_EVENTS       128
+#endif
+
+#ifndef BLOCKNOT_TRACE_TIMERS
+#define BLOCKNOT_TRACE_TIMERS       16
+#endif
+
+#define TRACE_OTHER_TIMER           0xFF
+
+/**
+ * One recorded event - time is micros() when it happened and lateness is in microseconds
+ */
+struct BlockNotTraceEvent {
+    uint32_t time;
+    uint32_t lateness;
+    uint8_t timer;
+    uint8_t event;
+};
+
+class BlockNotTrace {
+public:
+    static void begin();
+
+    static void end();
+
+    static bool isActive();
+
+    static void clear();
+
+    static uint8_t name(const BlockNot &timer, const char *label);
+
+    static uint8_t getTimerId(const BlockNot &timer);
+
+    static void record(const BlockNot &timer, BlockNotEvent event, unsigned long lateness);
+
+    static uint16_t getCount();
+
+    static unsigned long getOverwritten();
+
+    static bool getEvent(uint16_t index, BlockNotTraceEvent &event);
+
+    static void writeChromeTrace(Print &output);
+
+    static void writeVcd(Print &output);
+
+private:
+    /**
+     * sequence is the event's number plus one once it is completely written, and zero while
+     * a writer is in the middle of it, so a reader can tell a whole event from a torn one
+     */
+    struct Slot {
+        BlockNotTraceEvent event;
+#ifdef BLOCKNOT_TRACE_ATOMIC
+        std::atomic<uint32_t> sequence;
+#else
+        volatile uint32_t sequence;
+#endif
+    };
+
+    static Slot slots[BLOCKNOT_TRACE_EVENTS];
+    static const BlockNot *timers[BLOCKNOT_TRACE_TIMERS];
+    static const char *labels[BLOCKNOT_TRACE_TIMERS];
+#ifdef BLOCKNOT_TRACE_ATOMIC
+    static std::atomic<uint32_t> written;
+#else
+    static volatile uint32_t written;
+#endif
+    static bool active;
+
+    static uint8_t assign(const BlockNot &timer);
+
+    static uint32_t claim();
+
+    static uint32_t total();
+
+    static uint8_t timerCount();
+
+    static void printName(Print &output, uint8_t id);
+};
+
+#endif